@@ -0,0 +1,349 @@
+// bench.cpp
+// Micro e macrobenchmarks dos caminhos quentes de visao e display.
+// Cada linha de saida e chave=valor, no mesmo formato do resumo de metricas,
+// para comparar execucoes entre versoes:
+//   bench=<nome> n=<amostras> media_ns=... p50_ns=... p99_ns=... max_ns=... [extras]
+//
+// Uso: bench [--replay arquivo.rec] [--quadros N] [--so nome]
+//   --replay   grab -> decisao sobre uma gravacao (senao quadros sinteticos)
+//   --quadros  quadros do benchmark de grab -> decisao (padrao 300)
+//   --so       roda so os benchmarks cujo nome comeca com o prefixo
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "camera.h"
+#include "classificador.h"
+#include "detector_mudanca.h"
+#include "hal.h"
+#include "hal_simulado.h"
+#include "lcd.h"
+#include "log.h"
+#include "metricas.h"
+
+namespace {
+
+volatile uint64_t sumidouro = 0;  // impede que o compilador descarte o trabalho medido
+std::string filtro;
+bool falhou = false;  // codigo de saida para o ctest
+
+// O filtro vale para o nome de cada linha emitida, nao para o grupo
+bool selecionado(const std::string& nome) {
+    return filtro.empty() || nome.compare(0, filtro.size(), filtro) == 0;
+}
+
+bool algumSelecionado(std::initializer_list<const char*> nomes) {
+    for (const char* nome : nomes) {
+        if (selecionado(nome)) return true;
+    }
+    return false;
+}
+
+// Amostras em ns por operacao; extras vao no fim da linha
+void imprimir(const std::string& nome, std::vector<double> amostras, const std::string& extras = "") {
+    if (!selecionado(nome)) return;
+    if (amostras.empty()) {
+        std::cout << "bench=" << nome << " n=0\n";
+        return;
+    }
+    std::sort(amostras.begin(), amostras.end());
+    double soma = 0;
+    for (double a : amostras) soma += a;
+    auto percentil = [&](double p) { return amostras[static_cast<size_t>(p * (amostras.size() - 1))]; };
+    std::printf("bench=%s n=%zu media_ns=%.1f p50_ns=%.1f p99_ns=%.1f max_ns=%.1f%s%s\n", nome.c_str(),
+                amostras.size(), soma / amostras.size(), percentil(0.5), percentil(0.99), amostras.back(),
+                extras.empty() ? "" : " ", extras.c_str());
+}
+
+// Mede lotes de porLote chamadas e devolve o custo medio por chamada de cada lote
+template <typename F>
+std::vector<double> medir(int lotes, int porLote, F&& f) {
+    for (int i = 0; i < porLote; i++) f();  // aquecimento: caches, tabelas, alocacoes
+    std::vector<double> amostras;
+    amostras.reserve(lotes);
+    for (int l = 0; l < lotes; l++) {
+        int64_t inicio = agoraNs();
+        for (int i = 0; i < porLote; i++) f();
+        amostras.push_back(static_cast<double>(agoraNs() - inicio) / porLote);
+    }
+    return amostras;
+}
+
+// Quadro BGR com faixas verticais de cores saturadas e ruido leve, para a
+// ROI central nao ser uniforme
+cv::Mat quadroSintetico(int largura, int altura, int variante) {
+    static const cv::Vec3b cores[] = {
+        {30, 30, 200}, {40, 190, 40}, {200, 40, 40}, {30, 210, 220}, {20, 20, 20}, {230, 230, 230},
+    };
+    cv::Mat bgr(altura, largura, CV_8UC3);
+    unsigned semente = 12345u + variante;
+    for (int y = 0; y < altura; y++) {
+        cv::Vec3b* linha = bgr.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < largura; x++) {
+            cv::Vec3b c = cores[(x * 6 / largura + variante) % 6];
+            semente = semente * 1103515245u + 12345u;
+            int ruido = static_cast<int>((semente >> 16) % 17) - 8;
+            for (int k = 0; k < 3; k++) c[k] = cv::saturate_cast<uint8_t>(c[k] + ruido);
+            linha[x] = c;
+        }
+    }
+    return bgr;
+}
+
+// BGR -> YUYV (BT.601 limitado), o formato que a camera entrega
+std::vector<uint8_t> paraYUYV(const cv::Mat& bgr) {
+    std::vector<uint8_t> yuyv(bgr.cols * bgr.rows * 2);
+    for (int y = 0; y < bgr.rows; y++) {
+        const cv::Vec3b* linha = bgr.ptr<cv::Vec3b>(y);
+        uint8_t* saida = yuyv.data() + y * bgr.cols * 2;
+        for (int x = 0; x < bgr.cols; x += 2) {
+            int lumas[2];
+            int u = 0, v = 0;
+            for (int k = 0; k < 2; k++) {
+                int b = linha[x + k][0], g = linha[x + k][1], r = linha[x + k][2];
+                lumas[k] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+                u += ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+                v += ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+            }
+            saida[x * 2 + 0] = cv::saturate_cast<uint8_t>(lumas[0]);
+            saida[x * 2 + 1] = cv::saturate_cast<uint8_t>(u / 2);
+            saida[x * 2 + 2] = cv::saturate_cast<uint8_t>(lumas[1]);
+            saida[x * 2 + 3] = cv::saturate_cast<uint8_t>(v / 2);
+        }
+    }
+    return yuyv;
+}
+
+// Media da ROI central: direto do buffer cru (caminho sem copyFrame) e a
+// partir do quadro BGR inteiro (caminho original com cv::mean)
+void benchROI() {
+    const int largura = 640, altura = 480;
+    cv::Mat bgr = quadroSintetico(largura, altura, 0);
+    std::vector<uint8_t> yuyv = paraYUYV(bgr);
+    cv::Rect roi = centralROI(bgr.size(), 20);
+    std::string extras = "roi=" + std::to_string(roi.width) + "x" + std::to_string(roi.height);
+
+    if (selecionado("roi_bruto_yuyv")) {
+        cv::Mat roiBGR;
+        cv::Scalar media;
+        imprimir("roi_bruto_yuyv", medir(200, 100, [&] {
+                     extractRawROI(yuyv.data(), largura * 2, PixelFormat::YUYV, roi, roiBGR, media);
+                     sumidouro += static_cast<uint64_t>(media[0]);
+                 }), extras);
+    }
+    if (selecionado("roi_bruto_bgr")) {
+        cv::Mat roiBGR;
+        cv::Scalar media;
+        imprimir("roi_bruto_bgr", medir(200, 100, [&] {
+                     extractRawROI(bgr.data, bgr.step, PixelFormat::BGR, roi, roiBGR, media);
+                     sumidouro += static_cast<uint64_t>(media[0]);
+                 }), extras);
+    }
+    if (selecionado("roi_mean_bgr")) {
+        imprimir("roi_mean_bgr", medir(200, 100, [&] {
+                     cv::Scalar media = cv::mean(bgr(roi));
+                     sumidouro += static_cast<uint64_t>(media[0]);
+                 }), extras);
+    }
+}
+
+// Classificacao de uma ROI 20x20: regras originais pixel a pixel contra o
+// classificador por tabela (RGB e HSV); o custo e por ROI
+void benchClassificacao() {
+    cv::Mat bgr = quadroSintetico(640, 480, 0);
+    cv::Mat roi = bgr(centralROI(bgr.size(), 20)).clone();
+    std::string extras = "pixels=" + std::to_string(roi.total());
+
+    if (selecionado("cor_detectColorRGB_media")) {
+        // Caminho original: media da ROI e uma chamada de detectColorRGB
+        imprimir("cor_detectColorRGB_media", medir(200, 100, [&] {
+                     int r, g, b;
+                     sumidouro += analisarROI(roi, cv::Rect(0, 0, roi.cols, roi.rows), r, g, b).size();
+                 }), extras);
+    }
+    if (selecionado("cor_detectColorRGB_pixels")) {
+        imprimir("cor_detectColorRGB_pixels", medir(100, 10, [&] {
+                     for (int y = 0; y < roi.rows; y++) {
+                         const cv::Vec3b* linha = roi.ptr<cv::Vec3b>(y);
+                         for (int x = 0; x < roi.cols; x++) sumidouro += detectColorRGB(linha[x]).size();
+                     }
+                 }), extras);
+    }
+    if (selecionado("cor_referencia_hsv_pixels")) {
+        imprimir("cor_referencia_hsv_pixels", medir(100, 10, [&] {
+                     for (int y = 0; y < roi.rows; y++) {
+                         const cv::Vec3b* linha = roi.ptr<cv::Vec3b>(y);
+                         for (int x = 0; x < roi.cols; x++) {
+                             int h, s, v;
+                             bgrParaHSV(linha[x][0], linha[x][1], linha[x][2], h, s, v);
+                             sumidouro += static_cast<uint64_t>(corReferenciaHSV(h, s, v));
+                         }
+                     }
+                 }), extras);
+    }
+    const RegrasCor regras[] = {RegrasCor::RGB, RegrasCor::HSV};
+    for (RegrasCor r : regras) {
+        std::string nome = r == RegrasCor::RGB ? "cor_tabela_rgb_votar" : "cor_tabela_hsv_votar";
+        if (!selecionado(nome)) continue;
+        ClassificadorCor classificador(r);
+        imprimir(nome, medir(200, 100, [&] {
+                     sumidouro += classificador.votar(roi).total;
+                 }), extras);
+    }
+}
+
+// Grab -> decisao: fonte real (gravacao ou arquivo cru), media da ROI,
+// votacao e histerese, como a thread da camera sem o anel no meio
+void benchGrabDecisao(const std::string& replay, int quadros) {
+    if (!algumSelecionado({"grab_decisao_grab", "grab_decisao"})) return;
+
+    CameraConfig config;
+    config.copyFrame = false;
+    std::string temporario;
+    std::unique_ptr<FrameSource> fonte;
+    if (!replay.empty()) {
+        config.replayFile = replay;
+        config.replayRealtime = false;
+        config.replayLoop = true;
+        fonte = createReplaySource(config);
+    } else {
+        // Quadros sinteticos YUYV num arquivo temporario, lidos pela fonte fake
+        char caminho[] = "/tmp/bench-quadrosXXXXXX";
+        int fd = mkstemp(caminho);
+        if (fd < 0) {
+            std::cout << "bench=grab_decisao erro=\"arquivo temporario\"\n";
+            falhou = true;
+            return;
+        }
+        temporario = caminho;
+        for (int v = 0; v < 6; v++) {
+            std::vector<uint8_t> yuyv = paraYUYV(quadroSintetico(config.width, config.height, v));
+            if (write(fd, yuyv.data(), yuyv.size()) != static_cast<ssize_t>(yuyv.size())) break;
+        }
+        close(fd);
+        config.fakeFile = temporario;
+        config.format = PixelFormat::YUYV;
+        config.fakeFps = 0;
+        fonte = createRawFileSource(config);
+    }
+
+    if (!fonte || !fonte->open()) {
+        std::cout << "bench=grab_decisao erro=\"fonte nao abriu\"\n";
+        falhou = true;
+        if (!temporario.empty()) unlink(temporario.c_str());
+        return;
+    }
+
+    ClassificadorCor classificador(RegrasCor::RGB);
+    HistereseCor histerese;
+    Frame frame;
+    std::vector<double> grab, decisao;
+    int trocas = 0;
+    for (int i = 0; i < quadros; i++) {
+        int64_t inicio = agoraNs();
+        if (!fonte->grab(frame)) break;
+        int64_t capturado = agoraNs();
+        ResultadoCor resultado = classificador.votar(frame.roiBGR);
+        if (histerese.atualizar(resultado.cor, resultado.confianca)) trocas++;
+        int64_t fim = agoraNs();
+        grab.push_back(static_cast<double>(capturado - inicio));
+        decisao.push_back(static_cast<double>(fim - inicio));
+    }
+    fonte->close();
+    if (!temporario.empty()) unlink(temporario.c_str());
+
+    std::string extras = std::string("fonte=") + fonte->name() + " trocas=" + std::to_string(trocas);
+    imprimir("grab_decisao_grab", grab, extras);
+    imprimir("grab_decisao", decisao, extras);
+}
+
+// Custo de uma tela no LCD pelo transporte GPIO, sobre o HAL simulado: CPU
+// gasta no lcdPresent() (inclui a decodificacao do LCD virtual) e tempo de
+// barramento que o HD44780 real levaria
+void benchLCD() {
+    if (!algumSelecionado({"lcd_tela_parcial_cpu", "lcd_tela_parcial_barramento", "lcd_tela_completa_cpu",
+                           "lcd_tela_completa_barramento"})) {
+        return;
+    }
+
+    GpioSimulado* sim = new GpioSimulado();
+    usarGpio(std::unique_ptr<Gpio>(sim));
+    LcdVirtual& lcd = sim->conectarLcd(0, 1, 4, 5, 6, 7);
+    lcdInit(createGpioTransport(0, 1, 4, 5, 6, 7));
+
+    // Telas como as do main: linha de estado fixa e cor mudando
+    static const char* cores[] = {"Vermelho", "Verde", "Azul", "Amarelo", "Preto", "Branco"};
+    struct Custo {
+        std::vector<double> cpu, barramento;
+        uint64_t bytes = 0;
+    };
+    Custo parcial, completa;
+    const int telas = 250;
+    for (int i = 0; i < 2 * telas; i++) {
+        // Primeiro telas parciais (so a cor muda), depois completas (as duas linhas mudam)
+        bool inteira = i >= telas;
+        Custo& c = inteira ? completa : parcial;
+        lcdCompose(0, inteira && i % 2 ? "Sistema ATIVO" : "Sistema ativo");
+        lcdCompose(1, std::string("Cor:") + cores[i % 6]);
+
+        uint64_t bytesAntes = lcd.comandos() + lcd.dados();
+        int64_t avancoAntes = gpio().agora() - agoraNs();
+        int64_t inicio = agoraNs();
+        lcdPresent();
+        int64_t fim = agoraNs();
+        int64_t avanco = gpio().agora() - fim - avancoAntes;
+
+        c.cpu.push_back(static_cast<double>(fim - inicio));
+        c.barramento.push_back(static_cast<double>(avanco));
+        c.bytes += lcd.comandos() + lcd.dados() - bytesAntes;
+    }
+
+    auto extras = [&](const Custo& c) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "bytes_por_tela=%.1f violacoes=%llu",
+                      c.cpu.empty() ? 0.0 : static_cast<double>(c.bytes) / c.cpu.size(),
+                      static_cast<unsigned long long>(lcd.totalViolacoes()));
+        return std::string(buf);
+    };
+    imprimir("lcd_tela_parcial_cpu", parcial.cpu, extras(parcial));
+    imprimir("lcd_tela_parcial_barramento", parcial.barramento, extras(parcial));
+    imprimir("lcd_tela_completa_cpu", completa.cpu, extras(completa));
+    imprimir("lcd_tela_completa_barramento", completa.barramento, extras(completa));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string replay;
+    int quadros = 300;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string opcao = argv[i];
+        std::string valor = argv[i + 1];
+        if (opcao == "--replay") replay = valor;
+        else if (opcao == "--quadros") quadros = std::atoi(valor.c_str());
+        else if (opcao == "--so") filtro = valor;
+        else {
+            std::cerr << "Opcao desconhecida: " << opcao << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "Opcao sem valor: " << argv[argc - 1] << std::endl;
+        return 1;
+    }
+
+    // So erros: o log sincrono no meio das medidas distorceria os tempos
+    definirNivelLog(NivelLog::Erro);
+
+    benchROI();
+    benchClassificacao();
+    benchGrabDecisao(replay, quadros);
+    benchLCD();
+    return falhou ? 1 : 0;
+}
@@ -1,7 +1,41 @@
 #ifndef BOTAO_H
 #define BOTAO_H
 
+#include <cstdint>
+#include <functional>
+
 void configurarBotao(int pino);
 bool verificarPressionado(int pino, bool& ultimoEstado);
 
+// Evento de borda do botao, com timestamp CLOCK_MONOTONIC tirado na interrupcao
+struct EventoBotao {
+    int pino;
+    int64_t timestampNs;
+};
+
+using CallbackBotao = std::function<void(const EventoBotao&)>;
+
+// Entrada por interrupcao (gpio().registrarInterrupcao, ambas as bordas) com debounce por
+// estado: so conta o aperto que chega depois de debounceMs de linha estavel em HIGH.
+// Suporta um botao por processo. Retorna false se a interrupcao nao puder ser registrada
+// (o backend wiringPi nao chega a retornar: wiringPiISR encerra o processo ao falhar).
+bool iniciarEventosBotao(int pino, int debounceMs = 30);
+
+// Se houver callback, ele e chamado direto da thread de interrupcao e o evento
+// nao vai para a fila
+void registrarCallbackBotao(CallbackBotao callback);
+
+// Bloqueia ate chegar um evento (timeoutMs < 0 = sem limite).
+// Retorna false em timeout ou depois de pararEventosBotao().
+bool aguardarEventoBotao(EventoBotao& evento, int timeoutMs = -1);
+
+// eventfd que fica legivel quando ha eventos na fila (para poll/epoll)
+int fdEventosBotao();
+
+// Acorda quem estiver em aguardarEventoBotao() para encerrar
+void pararEventosBotao();
+
+// Eventos descartados por fila cheia
+uint64_t eventosBotaoDescartados();
+
 #endif
@@ -2,11 +2,73 @@
 #define CAMERA_H
 
 #include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include "frame_ring.h"
 
 bool openCamera(cv::VideoCapture& cap, int device = 0);
 void closeCamera(cv::VideoCapture& cap);
 std::string detectColorRGB(const cv::Vec3b& pixel);
 std::string processFrame(cv::VideoCapture& cap, int& r, int& g, int& b);
 
+// Regiao quadrada no centro do quadro (recortada aos limites dele) e classificacao pela media
+cv::Rect centralROI(const cv::Mat& frame, int tamanho = 20);
+cv::Rect centralROI(cv::Size size, int tamanho = 20);
+std::string analisarROI(const cv::Mat& frame, const cv::Rect& roi, int& r, int& g, int& b);
+
+struct CameraConfig {
+    int device = 0;
+    int width = 640;
+    int height = 480;
+    PixelFormat format = PixelFormat::YUYV;  // formato pedido ao driver V4L2
+    int buffers = 4;                          // buffers mmap do kernel
+    int roiSize = 20;
+
+    // Converte o quadro inteiro para BGR em Frame::imagem. Desligado, so a
+    // ROI e convertida e a media sai direto do buffer do driver.
+    bool copyFrame = true;
+
+    // Se preenchido, le quadros crus (width x height no formato acima) deste
+    // arquivo em vez de abrir a camera; fakeFps limita o ritmo (0 = sem limite)
+    std::string fakeFile;
+    int fakeFps = 30;
+
+    // Se preenchido, reproduz uma gravacao (.rec, ver frame_recorder.h); o
+    // formato e o tamanho vem do arquivo. replayRealtime segue os intervalos
+    // gravados; desligado, entrega o mais rapido possivel.
+    std::string replayFile;
+    bool replayRealtime = true;
+    bool replayLoop = true;
+};
+
+// Fonte de quadros: preenche Frame::roi, roiBGR, roiMedia e bruto em toda
+// captura, e Frame::imagem (BGR) quando CameraConfig::copyFrame estiver ligado
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+    virtual bool open() = 0;
+    virtual bool grab(Frame& frame) = 0;
+    // Chamado de outra thread: um grab() esperando pelo ritmo retorna false logo
+    virtual void interromper() {}
+    virtual void close() = 0;
+    virtual const char* name() const = 0;
+};
+
+std::unique_ptr<FrameSource> createV4L2Source(const CameraConfig& config);
+std::unique_ptr<FrameSource> createVideoCaptureSource(const CameraConfig& config);
+std::unique_ptr<FrameSource> createRawFileSource(const CameraConfig& config);
+std::unique_ptr<FrameSource> createReplaySource(const CameraConfig& config);
+
+// Abre a gravacao ou o arquivo fake se configurados; senao tenta V4L2 e cai
+// para cv::VideoCapture. Retorna nullptr se nenhuma fonte abrir.
+std::unique_ptr<FrameSource> openCamera(const CameraConfig& config);
+
+// Operacoes sobre buffers crus (driver ou arquivo), sem copiar o quadro
+size_t rawFrameSize(PixelFormat format, int width, int height);
+void extractRawROI(const uint8_t* data, size_t stride, PixelFormat format, const cv::Rect& roi,
+                   cv::Mat& roiBGR, cv::Scalar& media);
+void convertRawToBGR(const uint8_t* data, size_t stride, PixelFormat format, int width, int height,
+                     cv::Mat& bgr);
+
 #endif // CAMERA_H
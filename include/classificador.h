@@ -0,0 +1,73 @@
+#ifndef CLASSIFICADOR_H
+#define CLASSIFICADOR_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+enum class Cor : uint8_t {
+    Indefinido = 0,
+    Vermelho,
+    Verde,
+    Azul,
+    Amarelo,
+    Rosa,
+    Preto,
+    Branco,
+    Cinza,
+    Ciano,
+    Roxo,
+    Total
+};
+
+constexpr int NUM_CORES = static_cast<int>(Cor::Total);
+
+const char* nomeCor(Cor cor);
+
+// Implementacoes de referencia: as regras originais, um pixel por vez
+Cor corReferenciaRGB(int r, int g, int b);       // regras do detectColorRGB
+Cor corReferenciaHSV(int h, int s, int v);       // regras do detectColorHSV (H 0-179)
+void bgrParaHSV(int b, int g, int r, int& h, int& s, int& v);  // como o COLOR_BGR2HSV de 8 bits
+
+enum class RegrasCor { RGB, HSV };
+
+struct ResultadoCor {
+    Cor cor = Cor::Indefinido;
+    float confianca = 0.0f;     // fracao dos pixels que votaram na cor vencedora
+    int total = 0;
+    int votos[NUM_CORES] = {};
+};
+
+// Classificador por tabela: cada canal B/G/R e quantizado em faixas e a
+// combinacao das tres faixas indexa uma tabela 3-D montada na construcao a
+// partir das regras de referencia. Nas regras RGB as faixas seguem os
+// limiares das regras e a tabela e exata; nas regras HSV as faixas sao
+// uniformes (32 niveis) e a tabela guarda a cor do centro de cada celula.
+class ClassificadorCor {
+public:
+    explicit ClassificadorCor(RegrasCor regras = RegrasCor::RGB);
+
+    RegrasCor regras() const { return regras_; }
+
+    Cor classificar(uint8_t b, uint8_t g, uint8_t r) const {
+        return tabela_[(quant_[0][b] * niveis_[1] + quant_[1][g]) * niveis_[2] + quant_[2][r]];
+    }
+
+    // Classifica todos os pixels de uma imagem BGR (16 por vez com NEON/SSE2)
+    // e devolve o histograma de votos com a cor majoritaria
+    ResultadoCor votar(const cv::Mat& bgr) const;
+
+    // Classifica n pixels BGR consecutivos, escrevendo a Cor de cada um em classes
+    void classificarLinha(const uint8_t* bgr, int n, uint8_t* classes) const;
+
+private:
+    void indices16(const uint8_t* bgr, uint16_t* indices) const;
+
+    RegrasCor regras_;
+    std::vector<uint8_t> limites_[3];  // inicio de cada faixa (exceto a primeira), por canal
+    int niveis_[3];
+    uint8_t quant_[3][256];            // valor do canal -> faixa
+    std::vector<Cor> tabela_;
+};
+
+#endif // CLASSIFICADOR_H
@@ -0,0 +1,73 @@
+#ifndef DETECTOR_MUDANCA_H
+#define DETECTOR_MUDANCA_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "classificador.h"
+
+// Porteiro na frente do classificador: compara uma assinatura de luma por
+// blocos (grade de ate 16x12, amostrada) com a do ultimo quadro classificado.
+// Se nenhum bloco mudou mais que o limiar, o quadro nao precisa ser
+// classificado. A cada intervaloMaximo quadros pulados classifica de novo
+// mesmo assim, por seguranca.
+class DetectorMudanca {
+public:
+    explicit DetectorMudanca(int limiar = 8, int intervaloMaximo = 150);
+
+    // Calcula a assinatura de imagem (BGR) e diz se ela difere da referencia
+    bool precisaClassificar(const cv::Mat& imagem);
+    // Torna a ultima assinatura calculada a referencia
+    void aceitar();
+
+    // Custo medido de uma classificacao, para estimar a economia de CPU
+    void registrarCusto(int64_t ns);
+
+    uint64_t avaliados() const { return avaliados_; }
+    uint64_t pulados() const { return pulados_; }
+    // Liquida: pulados x custo medio da classificacao menos o custo do proprio
+    // porteiro em todos os quadros (pode ser negativa)
+    double economiaMs() const;
+    double custoPorteiroMs() const { return custoPorteiroNs_ / 1e6; }
+
+private:
+    bool compararAssinatura(const cv::Mat& imagem);
+
+    int limiar_;
+    int intervaloMaximo_;
+    int semMudanca_ = 0;
+    cv::Size tamanhoAtual_, tamanhoReferencia_;
+    std::vector<int> atual_;
+    std::vector<int> referencia_;
+    std::vector<int> amostras_;  // reaproveitado entre quadros
+    uint64_t avaliados_ = 0;
+    uint64_t pulados_ = 0;
+    int64_t custoTotalNs_ = 0;
+    int64_t custoPorteiroNs_ = 0;
+    uint64_t classificacoes_ = 0;
+};
+
+// Histerese da cor reportada: uma cor nova so substitui a atual depois de
+// vencer confirmacoes classificacoes seguidas com confianca minima
+class HistereseCor {
+public:
+    explicit HistereseCor(int confirmacoes = 3, float confiancaMinima = 0.6f);
+
+    // Retorna true se a cor reportada mudou
+    bool atualizar(Cor cor, float confianca);
+
+    Cor cor() const { return reportada_; }
+    bool valida() const { return valida_; }
+    // Sem troca de cor pendente de confirmacao
+    bool estavel() const { return contagem_ == 0; }
+
+private:
+    int confirmacoes_;
+    float confiancaMinima_;
+    bool valida_ = false;
+    Cor reportada_ = Cor::Indefinido;
+    Cor candidata_ = Cor::Indefinido;
+    int contagem_ = 0;
+};
+
+#endif // DETECTOR_MUDANCA_H
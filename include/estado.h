@@ -0,0 +1,59 @@
+#ifndef ESTADO_H
+#define ESTADO_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "classificador.h"
+#include "segmentacao.h"
+
+// Retrato do estado do sistema que o LCD (e quem mais quiser) mostra
+struct EstadoSistema {
+    uint64_t versao = 0;  // cresce 1 a cada publicacao
+    bool ativo = false;
+    ModoDeteccao modo = ModoDeteccao::Centro;
+    Cor cor = Cor::Indefinido;
+    bool corRecebida = false;
+    uint8_t r = 0, g = 0, b = 0;  // media da ROI no quadro que decidiu a cor
+    float confianca = 0.0f;
+    int objetos = 0;
+};
+
+// Seqlock: quem escreve nunca espera quem le. Leitores copiam o estado e so
+// repetem a copia se uma escrita aconteceu no meio. Escritores (camera e
+// laco, raros) se revezam pelo proprio contador de sequencia. O estado fica
+// em palavras atomicas, entao a copia concorrente nao e corrida de dados.
+class EstadoCompartilhado {
+public:
+    EstadoCompartilhado();
+
+    // Copia consistente do estado mais recente
+    EstadoSistema ler() const;
+    uint64_t versao() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+    // Aplica alterar() sobre o estado atual e publica; retorna a nova versao
+    template <typename F>
+    uint64_t atualizar(F alterar) {
+        uint64_t s = travarEscrita();
+        EstadoSistema estado = carregar();
+        alterar(estado);
+        estado.versao = s / 2 + 1;
+        guardar(estado);
+        seq_.store(s + 1, std::memory_order_release);
+        return estado.versao;
+    }
+
+private:
+    static_assert(std::is_trivially_copyable<EstadoSistema>::value, "copiado palavra a palavra");
+    static constexpr size_t PALAVRAS = (sizeof(EstadoSistema) + 7) / 8;
+
+    uint64_t travarEscrita();
+    EstadoSistema carregar() const;
+    void guardar(const EstadoSistema& estado);
+
+    std::atomic<uint64_t> seq_{0};  // impar = escrita em andamento
+    std::atomic<uint64_t> dados_[PALAVRAS];
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "classificador.h"
+#include "frame_ring.h"
+
+// Arquivo de gravacao (.rec), so de acrescimo, little-endian:
+//   CabecalhoGravacao
+//   repetido: CabecalhoRegistro + carga de `tamanho` bytes
+// Quadro: carga = quadro cru compactado (sem padding de linha) no formato
+// do cabecalho. Decisao: carga = RegistroDecisao do quadro `seq`.
+// Um registro cortado no fim (queda de energia) e ignorado na leitura.
+constexpr char MAGIC_GRAVACAO[8] = {'S', 'O', 'E', 'R', 'E', 'C', '1', '\0'};
+
+struct CabecalhoGravacao {
+    char magic[8];
+    uint32_t versao;
+    uint32_t formato;  // PixelFormat
+    uint32_t largura;
+    uint32_t altura;
+    uint32_t reservado[2];
+};
+
+enum class TipoRegistro : uint32_t { Quadro = 1, Decisao = 2 };
+
+struct CabecalhoRegistro {
+    uint32_t tipo;
+    uint32_t tamanho;
+    uint64_t seq;
+    int64_t timestampNs;  // da captura original
+};
+
+struct RegistroDecisao {
+    int32_t roi[4];  // x, y, largura, altura
+    float media[3];  // B, G, R
+    float confianca;
+    uint8_t cor;     // Cor
+    uint8_t reservado[3];
+};
+
+// Grava quadros crus e decisoes sem segurar a captura: o quadro e copiado
+// para um buffer de um pool fixo e uma thread propria escreve no disco.
+// Com o pool esgotado (disco lento) o quadro e descartado e contado.
+class FrameRecorder {
+public:
+    explicit FrameRecorder(size_t buffers = 8);
+    ~FrameRecorder();
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    bool open(const std::string& path);
+    void close();  // escreve o que falta na fila e fecha
+
+    // Usa Frame::bruto; chamar antes do proximo grab() da fonte
+    void recordFrame(const Frame& frame);
+    void recordDecision(uint64_t seq, int64_t timestampNs, const cv::Rect& roi, const cv::Scalar& media,
+                        Cor cor, float confianca);
+
+    uint64_t recorded() const { return recorded_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    struct Item {
+        CabecalhoRegistro cabecalho;
+        std::vector<uint8_t> dados;
+    };
+
+    void writerLoop();
+    bool writeAll(const void* data, size_t size);
+
+    size_t buffers_;
+    int fd_ = -1;
+    std::thread writer_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<Item> fila_;
+    std::vector<std::vector<uint8_t>> livres_;
+    size_t emUso_ = 0;
+    bool parar_ = false;
+
+    bool temCabecalho_ = false;  // definido pelo primeiro quadro
+    CabecalhoGravacao cabecalho_{};
+    std::atomic<uint64_t> recorded_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// Leitura de uma gravacao inteira via mmap (sem copiar os quadros)
+class RecordingReader {
+public:
+    struct QuadroGravado {
+        uint64_t seq;
+        int64_t timestampNs;
+        const uint8_t* dados;
+    };
+    struct DecisaoGravada {
+        uint64_t seq;
+        int64_t timestampNs;
+        RegistroDecisao decisao;
+    };
+
+    RecordingReader() = default;
+    ~RecordingReader();
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    PixelFormat format() const { return static_cast<PixelFormat>(cabecalho_.formato); }
+    cv::Size size() const { return cv::Size(cabecalho_.largura, cabecalho_.altura); }
+    size_t stride() const;
+    const std::vector<QuadroGravado>& frames() const { return quadros_; }
+    const std::vector<DecisaoGravada>& decisions() const { return decisoes_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+    CabecalhoGravacao cabecalho_{};
+    std::vector<QuadroGravado> quadros_;
+    std::vector<DecisaoGravada> decisoes_;
+};
+
+#endif // FRAME_RECORDER_H
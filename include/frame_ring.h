@@ -0,0 +1,80 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "classificador.h"
+#include "segmentacao.h"
+
+// Formato dos pixels no buffer da fonte
+enum class PixelFormat { BGR, YUYV, GREY };
+
+struct Frame {
+    cv::Mat imagem;           // BGR; vazio se a fonte nao copia o quadro inteiro
+    uint64_t seq = 0;
+    int64_t timestampNs = 0;  // CLOCK_MONOTONIC na captura
+
+    // ROI central, ja em BGR, e a media dela (calculadas pela fonte)
+    cv::Rect roi;
+    cv::Mat roiBGR;
+    cv::Scalar roiMedia;
+
+    // Quadro cru como a fonte entregou (buffer do driver ou do arquivo).
+    // So vale ate o proximo grab() da mesma fonte: serve para gravar.
+    const uint8_t* bruto = nullptr;
+    size_t brutoStride = 0;
+    PixelFormat brutoFormato = PixelFormat::BGR;
+    cv::Size brutoTamanho;
+
+    // Anotacoes preenchidas pela analise (usadas pelo preview)
+    Cor cor = Cor::Indefinido;
+    std::vector<Objeto> objetos;
+};
+
+// Anel de tres quadros pre-alocados entre um produtor e um consumidor.
+// O produtor sempre tem um slot livre e nunca bloqueia; o consumidor sempre
+// pega o quadro mais novo e os intermediarios sao descartados. Os slots
+// giram por troca atomica de indices, sem mutex; um eventfd avisa o consumidor.
+class FrameRing {
+public:
+    FrameRing();
+    ~FrameRing();
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // Produtor: slot exclusivo para escrever (o cv::Mat e reaproveitado)
+    Frame& escrita();
+    // Produtor: torna o slot escrito o quadro mais recente
+    void publicar();
+
+    // Consumidor: quadro mais novo ou nullptr se nada chegou desde a ultima chamada.
+    // O ponteiro vale ate a proxima chamada de maisRecente()/aguardar().
+    Frame* maisRecente();
+    // Consumidor: como maisRecente(), mas espera ate timeoutMs por um quadro novo
+    Frame* aguardar(int timeoutMs);
+
+    // Faz um aguardar() pendente retornar (nullptr se nao ha quadro novo)
+    void acordar();
+
+    // eventfd legivel quando ha quadro novo (para poll/epoll)
+    int fd() const { return fd_; }
+
+    uint64_t publicados() const { return publicados_; }
+    uint64_t descartados() const { return descartados_; }
+
+private:
+    static constexpr unsigned NOVO = 4;
+
+    Frame slots_[3];
+    unsigned escrita_ = 0;            // so o produtor mexe
+    unsigned leitura_ = 1;            // so o consumidor mexe
+    std::atomic<unsigned> meio_{2};   // slot trocado entre os dois (| NOVO se ainda nao lido)
+    std::atomic<bool> acordado_{false};  // acordar() pendente, sobrevive ao read do eventfd
+    int fd_ = -1;
+    std::atomic<uint64_t> publicados_{0};
+    std::atomic<uint64_t> descartados_{0};
+};
+
+#endif // FRAME_RING_H
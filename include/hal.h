@@ -0,0 +1,44 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <cstdint>
+#include <memory>
+
+// Acesso ao GPIO atras de uma interface (numeracao BCM). O backend real usa
+// wiringPi + /dev/gpiomem (hal_wiringpi.cpp, fora da biblioteca); o simulado
+// (hal_simulado.h) roda em qualquer Linux.
+// Botao, laser e o transporte GPIO do LCD so falam com gpio().
+enum class Borda { Descida, Subida, Ambas };
+
+class Gpio {
+public:
+    virtual ~Gpio() = default;
+
+    virtual bool iniciar() = 0;
+    virtual void modoSaida(int pino) = 0;
+    virtual void modoEntrada(int pino, bool pullUp) = 0;
+    virtual void escrever(int pino, bool nivel) = 0;
+    virtual bool ler(int pino) = 0;
+
+    // Pinos 0-31 de uma vez: bits de set e de clear aplicados juntos
+    virtual void escreverMascara(uint32_t set, uint32_t clr) = 0;
+
+    // O tratador roda numa thread do backend a cada borda
+    virtual bool registrarInterrupcao(int pino, Borda borda, void (*tratador)()) = 0;
+
+    // Relogio do backend (CLOCK_MONOTONIC no real) e esperas de barramento:
+    // esperarNs() e ocupada (ns a dezenas de us), dormirUs() cede a CPU
+    virtual int64_t agora() = 0;
+    virtual void esperarNs(long ns) = 0;
+    virtual void dormirUs(long us) = 0;
+};
+
+// Backend em uso; se ninguem chamou usarGpio(), o simulado
+Gpio& gpio();
+// Troca o backend; chamar antes de configurar qualquer pino
+void usarGpio(std::unique_ptr<Gpio> backend);
+
+// So no executavel compilado com wiringPi (COM_WIRINGPI, ver CMakeLists.txt)
+std::unique_ptr<Gpio> createWiringPiGpio();
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef HAL_SIMULADO_H
+#define HAL_SIMULADO_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hal.h"
+
+struct Transicao {
+    int64_t tempoNs;  // relogio simulado nos pinos do LCD, real nos demais
+    bool nivel;
+};
+
+// HD44780 virtual pendurado nos pinos do GpioSimulado. Decodifica os nibbles
+// (modo 8 bits ate o function set com DL=0, depois pares de nibbles), mantem
+// a DDRAM e confere cada pulso contra o datasheet a 3.3 V: tAS >= 40 ns,
+// PWEH >= 450 ns, tcycE >= 1000 ns, tDSW >= 195 ns, tH >= 10 ns, 40 ms apos
+// ligar e o tempo de execucao da instrucao anterior (37 us, 1.52 ms para
+// clear/home, 4.1 ms/100 us na sequencia de inicializacao).
+class LcdVirtual {
+public:
+    LcdVirtual(int rs, int e, int d4, int d5, int d6, int d7, int cols, int rows, int64_t ligadoNs);
+
+    // Chamado pelo GpioSimulado a cada mudanca de nivel: t no relogio simulado
+    // (confere os tempos), tReal no monotonico; niveis = estado de todos os pinos
+    void aoMudar(int pino, bool nivel, int64_t t, int64_t tReal, const bool* niveis);
+
+    std::string linha(int row) const;
+    uint64_t comandos() const { return comandos_; }
+    uint64_t dados() const { return dados_; }
+    // Custo medio de barramento por byte: subida do E do primeiro nibble ate o fim da execucao
+    double nsPorByte() const { return bytesMedidos_ ? static_cast<double>(nsBytes_) / bytesMedidos_ : 0.0; }
+    uint64_t totalViolacoes() const { return totalViolacoes_; }
+    const std::vector<std::string>& violacoes() const { return violacoes_; }
+    const std::vector<int64_t>& momentosDados() const { return momentosDados_; }
+
+private:
+    void violacao(const std::string& texto, int64_t t);
+    void latch(uint8_t nibble, bool rs, int64_t t);
+    void executar(uint8_t byte, bool rs, int64_t t);
+    int rowAddress(int row) const;
+
+    int rs_, e_, d_[4];
+    int cols_, rows_;
+    int64_t ligadoNs_;
+
+    bool eAlto_ = false;
+    int64_t eSubiu_ = -1;
+    int64_t eDesceu_ = -1;
+    int64_t rsMudou_ = 0;
+    int64_t dadosMudaram_ = 0;
+
+    bool modo4Bits_ = false;
+    int inicializacao_ = 0;  // quantos 0x3 ja vieram no modo 8 bits
+    bool temNibbleAlto_ = false;
+    uint8_t nibbleAlto_ = 0;
+    int64_t inicioByte_ = 0;
+    int64_t ocupadoAte_ = 0;
+
+    uint8_t ddram_[128];
+    uint8_t endereco_ = 0;
+
+    uint64_t comandos_ = 0;
+    uint64_t dados_ = 0;
+    int64_t nsBytes_ = 0;
+    uint64_t bytesMedidos_ = 0;
+    uint64_t totalViolacoes_ = 0;
+    std::vector<std::string> violacoes_;  // so as primeiras
+    std::vector<int64_t> momentosDados_;  // latch de cada byte de dado, relogio real (limitado)
+};
+
+// Mudanca de nivel agendada num pino de entrada, relativa ao inicio do roteiro
+struct PassoEntrada {
+    int64_t aposNs;
+    bool nivel;
+};
+
+// Backend sem hardware: guarda o nivel dos pinos, a linha do tempo de cada
+// saida e entrega interrupcoes a partir de roteiros. As esperas de barramento
+// nao esperam de verdade (a menos de esperasReais): so adiantam o relogio
+// simulado da thread que esperou, entao o LCD virtual mede o tempo que o
+// barramento real levaria. So os pinos do LCD usam esse relogio; laser e
+// botao ficam no relogio real, sem o tempo de barramento somado.
+class GpioSimulado : public Gpio {
+public:
+    explicit GpioSimulado(bool esperasReais = false);
+    ~GpioSimulado() override;
+
+    bool iniciar() override { return true; }
+    void modoSaida(int pino) override;
+    void modoEntrada(int pino, bool pullUp) override;
+    void escrever(int pino, bool nivel) override;
+    bool ler(int pino) override;
+    void escreverMascara(uint32_t set, uint32_t clr) override;
+    bool registrarInterrupcao(int pino, Borda borda, void (*tratador)()) override;
+    int64_t agora() override;
+    void esperarNs(long ns) override;
+    void dormirUs(long us) override;
+
+    LcdVirtual& conectarLcd(int rs, int e, int d4, int d5, int d6, int d7, int cols = 16, int rows = 2);
+
+    // Executa os passos numa thread propria, em tempo real, disparando a
+    // interrupcao registrada nas bordas correspondentes
+    void roteiro(int pino, std::vector<PassoEntrada> passos);
+    // Cliques de botao com pull-up: desce nos instantes dados (ms) e solta
+    // 100 ms depois, com repiques de 1 ms no aperto e na soltura
+    static std::vector<PassoEntrada> cliques(const std::vector<int>& instantesMs, int repiques = 3);
+
+    std::vector<Transicao> transicoes(int pino) const;
+
+    // Linhas chave=valor: tela e violacoes do LCD, latencia clique -> LCD e
+    // erro das trocas do laser contra o padrao (ms ligado/desligado)
+    std::string relatorio(int pinoBotao, int pinoLaser, const std::vector<int>& padraoLaserMs) const;
+
+private:
+    static constexpr int NUM_PINOS = 64;
+
+    void mudar(int pino, bool nivel, int64_t t, int64_t tReal);
+
+    bool esperasReais_;
+
+    mutable std::mutex mtx_;
+    bool niveis_[NUM_PINOS] = {};
+    bool saida_[NUM_PINOS] = {};
+    bool barramento_[NUM_PINOS] = {};  // pinos ligados a um LCD virtual
+    std::vector<Transicao> linhas_[NUM_PINOS];
+    std::vector<int64_t> cliquesInjetados_;  // primeira descida de cada clique
+    void (*tratadores_[NUM_PINOS])() = {};
+    Borda bordas_[NUM_PINOS] = {};
+    std::vector<std::unique_ptr<LcdVirtual>> lcds_;
+
+    std::atomic<bool> parar_{false};
+    std::vector<std::thread> roteiros_;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef LACO_EVENTOS_H
+#define LACO_EVENTOS_H
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Laco de eventos de uma thread sobre epoll. Tudo que acorda o laco e um fd:
+// timers sao timerfd, tarefas postadas por outras threads usam um eventfd,
+// sinais chegam por signalfd e as bordas do botao pelo eventfd do botao.
+// Sem nada agendado a thread fica bloqueada no epoll_wait.
+class LacoEventos {
+public:
+    using Callback = std::function<void()>;
+
+    LacoEventos();
+    ~LacoEventos();
+    LacoEventos(const LacoEventos&) = delete;
+    LacoEventos& operator=(const LacoEventos&) = delete;
+
+    // Chama callback sempre que fd estiver legivel; o callback deve consumir o evento
+    void observar(int fd, Callback callback);
+    void esquecer(int fd);
+
+    // Timers (timerfd, CLOCK_MONOTONIC). O id retornado e o proprio fd.
+    int criarTimer(Callback callback);
+    void armarTimer(int id, int64_t atrasoNs, int64_t periodoNs = 0);
+    void armarTimerAbsoluto(int id, int64_t instanteNs);
+    void desarmarTimer(int id);
+    void destruirTimer(int id);
+
+    // Bloqueia os sinais no processo inteiro e os entrega como evento do laco.
+    // Chamar antes de criar outras threads, para elas herdarem a mascara.
+    bool observarSinais(std::initializer_list<int> sinais, Callback callback);
+
+    // Executa callback na thread do laco; pode ser chamado de qualquer thread
+    void postar(Callback callback);
+
+    // Roda ate parar(); parar() pode ser chamado de qualquer thread
+    void executar();
+    void parar();
+
+private:
+    void executarPostados();
+
+    int epoll_ = -1;
+    int eventoPostado_ = -1;
+    bool rodando_ = false;
+    std::unordered_map<int, Callback> callbacks_;
+    std::vector<int> timers_;
+    std::vector<int> sinais_;
+
+    std::mutex mtxPostados_;
+    std::vector<Callback> postados_;
+};
+
+#endif
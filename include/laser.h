@@ -1,9 +1,40 @@
 #ifndef LASER_H
 #define LASER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LacoEventos;
+
 void configurarLaser(int pino);
 void ligarLaser(int pino);
 void desligarLaser(int pino);
-void alternarLaser(int pino, bool& estado, int intervaloMs = 100);
+
+// Pisca o laser por timer do laco de eventos, sem bloquear nenhuma thread.
+// O padrao alterna duracoes ligado/desligado em ms e se repete ({500, 500}
+// = 1 Hz). Os prazos sao absolutos, entao o atraso de uma troca nao se acumula.
+class PiscaLaser {
+public:
+    PiscaLaser(LacoEventos& laco, int pino);
+    ~PiscaLaser();
+    PiscaLaser(const PiscaLaser&) = delete;
+    PiscaLaser& operator=(const PiscaLaser&) = delete;
+
+    void iniciar(const std::vector<int>& padraoMs);
+    void parar();  // desarma e deixa o laser desligado
+    bool ativo() const { return ativo_; }
+
+private:
+    void avancar();
+
+    LacoEventos& laco_;
+    int pino_;
+    int timer_;
+    std::vector<int> padrao_;
+    size_t fase_ = 0;
+    int64_t prazoNs_ = 0;
+    bool ativo_ = false;
+};
 
 #endif
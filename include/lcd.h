@@ -1,11 +1,21 @@
 #ifndef LCD_H
 #define LCD_H
 
+#include <memory>
 #include <string>
+#include "lcd_transport.h"
 
-void lcdInit();
+// Sem transporte explicito usa o GPIO paralelo (RS=0, E=1, D4-D7=4-7, BCM)
+void lcdInit(int cols = 16, int rows = 2);
+void lcdInit(std::unique_ptr<LcdTransport> transport, int cols = 16, int rows = 2);
 void lcdClear();
 void lcdSetCursor(int row, int col);
 void lcdPrint(const std::string& text);
 
+// Modo retido: o chamador compoe a tela inteira e lcdPresent() envia so as
+// celulas que mudaram em relacao ao que ja esta no display, sem lcdClear()
+void lcdComposeClear();
+void lcdCompose(int row, const std::string& text, int col = 0);
+void lcdPresent();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef LCD_TRANSPORT_H
+#define LCD_TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Meio fisico de um HD44780 em modo 4 bits. O transporte cuida do pulso de
+// enable e do tempo de execucao de cada byte (37 us); esperas longas
+// (clear/home) ficam com o lcd.cpp.
+class LcdTransport {
+public:
+    virtual ~LcdTransport() = default;
+
+    virtual bool begin() = 0;
+
+    // Nibble isolado com RS=0, usado so na sequencia de inicializacao
+    virtual void writeNibble(uint8_t nibble) = 0;
+
+    // Envia len bytes com o mesmo RS (0 = comando, 1 = dado) de uma vez
+    virtual void write(const uint8_t* data, size_t len, bool rs) = 0;
+};
+
+// GPIO paralelo pelo gpio() (hal.h): RS/D4-D7 escritos juntos com
+// escreverMascara() quando estao no banco 0 (numeracao BCM)
+std::unique_ptr<LcdTransport> createGpioTransport(int rs, int e, int d4, int d5, int d6, int d7);
+
+// Backpack PCF8574: cada chamada de write() vira um unico write() no /dev/i2c-N.
+// Uma tela 16x2 inteira so cabe em 5 ms com o barramento a 400 kHz; begin()
+// avisa quando o device tree informa uma frequencia menor.
+std::unique_ptr<LcdTransport> createI2cTransport(const std::string& device = "/dev/i2c-1",
+                                                 int address = 0x27);
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Log assincrono. Cada thread escreve registros binarios (ponteiro do formato
+// + argumentos crus) num anel proprio, sem lock e sem formatar; uma thread de
+// fundo formata e escreve a cada 50 ms, ou antes se um anel passa da metade.
+// O formato usa "{}" para cada argumento e deve ser um literal, pois so o
+// ponteiro e guardado. Anel cheio descarta e conta.
+//
+//   LOG_INFO("[CAMERA] Cor detectada: {}", nomeCor(cor));
+//   LOG_LIMITADO(NivelLog::Aviso, 1, "[CAPTURA] Frame vazio!");  // ate 1/s
+
+enum class NivelLog : uint8_t { Debug, Info, Aviso, Erro };
+
+void definirNivelLog(NivelLog nivel);
+// Sem iniciarLog() (ou depois de pararLog()) as mensagens saem na hora, sincronas
+bool iniciarLog();
+void pararLog();  // esvazia os aneis e encerra a thread de fundo
+
+uint64_t logsDescartados();  // perdidos com o anel cheio
+uint64_t logsSuprimidos();   // barrados pelo limite de taxa
+
+namespace logdet {
+
+constexpr int MAX_ARGS = 6;
+constexpr int TAM_TEXTO = 48;  // strings sao copiadas para ca (truncadas)
+
+enum class TipoArg : uint8_t { Inteiro, SemSinal, Real, Texto, Booleano };
+
+struct Registro {
+    int64_t timestampNs;
+    const char* formato;
+    NivelLog nivel;
+    uint8_t nArgs;
+    uint8_t usoTexto;
+    TipoArg tipos[MAX_ARGS];
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        struct {
+            uint8_t inicio, tamanho;
+        } t;
+    } args[MAX_ARGS];
+    char texto[TAM_TEXTO];
+};
+
+extern std::atomic<int> nivelMinimo;
+
+Registro* reservar();  // slot no anel da thread, ou nullptr se cheio
+void confirmar();      // publica o slot reservado
+
+inline void guardarTexto(Registro& r, const char* s, size_t n) {
+    size_t livre = TAM_TEXTO - r.usoTexto;
+    if (n > livre) n = livre;
+    std::memcpy(r.texto + r.usoTexto, s, n);
+    r.args[r.nArgs].t.inicio = r.usoTexto;
+    r.args[r.nArgs].t.tamanho = static_cast<uint8_t>(n);
+    r.tipos[r.nArgs] = TipoArg::Texto;
+    r.usoTexto = static_cast<uint8_t>(r.usoTexto + n);
+}
+
+template <typename T>
+inline void codificar(Registro& r, const T& valor) {
+    if (r.nArgs >= MAX_ARGS) return;
+    if constexpr (std::is_same<T, bool>::value) {
+        r.args[r.nArgs].u = valor;
+        r.tipos[r.nArgs] = TipoArg::Booleano;
+    } else if constexpr (std::is_enum<T>::value) {
+        r.args[r.nArgs].i = static_cast<int64_t>(valor);
+        r.tipos[r.nArgs] = TipoArg::Inteiro;
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        r.args[r.nArgs].i = valor;
+        r.tipos[r.nArgs] = TipoArg::Inteiro;
+    } else if constexpr (std::is_integral<T>::value) {
+        r.args[r.nArgs].u = valor;
+        r.tipos[r.nArgs] = TipoArg::SemSinal;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        r.args[r.nArgs].d = valor;
+        r.tipos[r.nArgs] = TipoArg::Real;
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        guardarTexto(r, valor.data(), valor.size());
+    } else {
+        const char* s = valor;  // const char* / char[N]
+        guardarTexto(r, s, std::strlen(s));
+    }
+    r.nArgs++;
+}
+
+template <typename... Args>
+void registrar(NivelLog nivel, const char* formato, const Args&... args) {
+    Registro* r = reservar();
+    if (!r) return;
+    r->nivel = nivel;
+    r->formato = formato;
+    r->nArgs = 0;
+    r->usoTexto = 0;
+    (codificar(*r, args), ...);
+    confirmar();
+}
+
+inline bool ativo(NivelLog nivel) {
+    return static_cast<int>(nivel) >= nivelMinimo.load(std::memory_order_relaxed);
+}
+
+// Janela de um segundo por ponto de chamada
+class Limite {
+public:
+    explicit Limite(uint32_t porSegundo) : porSegundo_(porSegundo) {}
+    bool permitir();
+
+private:
+    uint32_t porSegundo_;
+    std::atomic<int64_t> janela_{-1};
+    std::atomic<uint32_t> usados_{0};
+};
+
+}  // namespace logdet
+
+#define LOG_NIVEL(nivel, ...)                                        \
+    do {                                                             \
+        if (logdet::ativo(nivel)) logdet::registrar(nivel, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_NIVEL(NivelLog::Debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_NIVEL(NivelLog::Info, __VA_ARGS__)
+#define LOG_AVISO(...) LOG_NIVEL(NivelLog::Aviso, __VA_ARGS__)
+#define LOG_ERRO(...) LOG_NIVEL(NivelLog::Erro, __VA_ARGS__)
+
+#define LOG_LIMITADO(nivel, porSegundo, ...)                             \
+    do {                                                                 \
+        static logdet::Limite limiteLog_(porSegundo);                    \
+        if (logdet::ativo(nivel) && limiteLog_.permitir())               \
+            logdet::registrar(nivel, __VA_ARGS__);                       \
+    } while (0)
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <cstdint>
+#include <string>
+
+// Relogio monotonico (CLOCK_MONOTONIC) em nanossegundos
+int64_t agoraNs();
+
+enum class Estagio {
+    Captura,        // timestamp do quadro (driver ou chegada) -> quadro convertido
+    ROI,            // estatisticas da ROI sobre o buffer
+    Classificacao,  // tabela/votacao ou segmentacao
+    Publicacao,     // publicacao do estado detectado
+    Decisao,        // captura do quadro -> cor decidida (ponta a ponta)
+    LCD,            // escrita no display
+    Laser,          // escrita no pino do laser
+    AtrasoLaser,    // instante agendado da troca -> troca efetiva
+    Preview,        // anotar + mostrar/codificar um quadro do preview
+    Total
+};
+
+enum class Contador {
+    QuadrosCapturados,
+    QuadrosAnalisados,
+    QuadrosDescartados,  // sobrescritos no anel antes da analise
+    QuadrosPulados,      // cena parada, sem classificacao
+    DespertaresLaco,     // retornos do epoll_wait no laco principal
+    LogsDescartados,     // mensagens de log perdidas com o anel cheio
+    Total
+};
+
+// Caminho quente: so incrementos atomicos relaxados num histograma
+// logaritmico (4 baldes por potencia de 2), sem locks nem alocacao
+void registrarLatencia(Estagio estagio, int64_t ns);
+void incrementar(Contador contador, uint64_t n = 1);
+void definir(Contador contador, uint64_t valor);
+
+// Mede do construtor ao destrutor
+class MedirEstagio {
+public:
+    explicit MedirEstagio(Estagio estagio) : estagio_(estagio), inicio_(agoraNs()) {}
+    ~MedirEstagio() { registrarLatencia(estagio_, agoraNs() - inicio_); }
+    MedirEstagio(const MedirEstagio&) = delete;
+    MedirEstagio& operator=(const MedirEstagio&) = delete;
+
+private:
+    Estagio estagio_;
+    int64_t inicio_;
+};
+
+// Texto com contadores, taxa de quadros e percentis de cada estagio
+std::string resumoMetricas();
+
+// Reescreve o arquivo com resumoMetricas() (via arquivo temporario + rename,
+// entao um "cat" nunca ve o arquivo pela metade)
+bool escreverMetricas(const std::string& arquivo);
+
+#endif
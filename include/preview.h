@@ -0,0 +1,50 @@
+#ifndef PREVIEW_H
+#define PREVIEW_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "frame_ring.h"
+
+// Nenhum: sem trabalho de GUI (producao/systemd). Janela: cv::imshow, precisa
+// de display. Mjpeg: JPEGs anotados por HTTP em 127.0.0.1, so com cliente conectado.
+enum class ModoPreview { Nenhum, Janela, Mjpeg };
+
+struct ConfigPreview {
+    ModoPreview modo = ModoPreview::Nenhum;
+    int porta = 8080;
+    double fps = 5.0;     // teto de quadros enviados ao preview
+    int qualidade = 70;   // JPEG
+    cv::Size tamanho{320, 240};
+};
+
+// Reduz o quadro para tamanho e desenha ROI, cor e objetos por cima
+void anotarQuadro(const Frame& frame, cv::Size tamanho, cv::Mat& saida);
+
+// Servidor HTTP minimo: cada conexao recebe um multipart/x-mixed-replace
+// (abre direto no navegador ou com "ffplay http://127.0.0.1:porta/").
+// Tudo roda na thread de quem chama; nao cria threads.
+class ServidorMjpeg {
+public:
+    ServidorMjpeg() = default;
+    ~ServidorMjpeg();
+    ServidorMjpeg(const ServidorMjpeg&) = delete;
+    ServidorMjpeg& operator=(const ServidorMjpeg&) = delete;
+
+    bool abrir(int porta);  // escuta so em 127.0.0.1
+    void fechar();
+
+    int fd() const { return fd_; }  // legivel quando ha conexao nova
+    void aceitar();
+    bool temClientes() const { return !clientes_.empty(); }
+
+    // Codifica uma vez e envia a todos; cliente lento ou fechado e derrubado
+    void enviar(const cv::Mat& quadro, int qualidade);
+
+private:
+    int fd_ = -1;
+    std::vector<int> clientes_;
+    std::vector<uchar> jpeg_;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SEGMENTACAO_H
+#define SEGMENTACAO_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "classificador.h"
+
+// Centro: so a ROI central (modo original). Objetos: o quadro inteiro e
+// segmentado em regioes de cor.
+enum class ModoDeteccao { Centro, Objetos };
+
+// Qual objeto vai para o LCD no modo Objetos
+enum class CriterioObjeto { Maior, MaisProximo };
+
+struct Objeto {
+    Cor cor = Cor::Indefinido;
+    int area = 0;             // em pixels
+    double cx = 0, cy = 0;    // centroide
+    cv::Rect caixa;
+};
+
+struct ConfigSegmentacao {
+    int areaMinima = 200;     // regioes menores sao descartadas como ruido
+    int faixas = 0;           // faixas de linhas processadas em paralelo (0 = cv::getNumThreads())
+};
+
+// Segmenta o quadro pelas classes do ClassificadorCor e extrai os componentes
+// conexos (vizinhanca 4) de cada cor. A classificacao e a rotulacao rodam em
+// paralelo por faixas horizontais; depois as faixas sao costuradas nas bordas.
+// Pixels Indefinido sao fundo.
+class SegmentadorCor {
+public:
+    SegmentadorCor(const ClassificadorCor& classificador, ConfigSegmentacao config = ConfigSegmentacao());
+
+    // Objetos ordenados por area (maior primeiro); vale ate a proxima chamada
+    const std::vector<Objeto>& segmentar(const cv::Mat& bgr);
+
+    // Mapa de classes (CV_8UC1 com valores de Cor) do ultimo quadro
+    const cv::Mat& classes() const { return classes_; }
+
+private:
+    void rotularFaixa(const cv::Mat& bgr, int y0, int y1);
+    int raiz(int rotulo);
+    void unir(int a, int b);
+
+    const ClassificadorCor& classificador_;
+    ConfigSegmentacao config_;
+    cv::Mat classes_;
+    std::vector<int> rotulos_;    // rotulo provisorio de cada pixel (0 = fundo)
+    std::vector<int> pai_;        // union-find; a raiz e sempre o menor rotulo
+    std::vector<int> objetoDaRaiz_;
+    std::vector<Objeto> objetos_;
+};
+
+// Objeto a mostrar segundo o criterio, ou nullptr se nao houver nenhum
+const Objeto* escolherObjeto(const std::vector<Objeto>& objetos, cv::Size tamanho, CriterioObjeto criterio);
+
+// Confianca na cor do objeto: fracao dos pixels classificados (nao
+// Indefinido) da caixa dele que tem a cor dele; 0 com a caixa vazia
+float purezaObjeto(const cv::Mat& classes, const Objeto& objeto);
+
+#endif // SEGMENTACAO_H
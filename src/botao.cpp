@@ -1,14 +1,150 @@
 #include "botao.h"
-#include <wiringPi.h>
+#include "hal.h"
+#include "metricas.h"
+#include <atomic>
+#include <mutex>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 void configurarBotao(int pino) {
-    pinMode(pino, INPUT);
-    pullUpDnControl(pino, PUD_UP);  // Ativa pull-up interno
+    gpio().modoEntrada(pino, true);  // Ativa pull-up interno
 }
 
 bool verificarPressionado(int pino, bool& ultimoEstado) {
-    bool estadoAtual = digitalRead(pino);
-    bool pressionado = (ultimoEstado == HIGH && estadoAtual == LOW);
+    bool estadoAtual = gpio().ler(pino);
+    bool pressionado = (ultimoEstado && !estadoAtual);
     ultimoEstado = estadoAtual;
     return pressionado;
 }
+
+namespace {
+
+// Fila SPSC: produtor e a thread de interrupcao do backend GPIO, consumidor e quem chama aguardarEventoBotao()
+constexpr unsigned TAMANHO_FILA = 16;
+
+EventoBotao fila[TAMANHO_FILA];
+std::atomic<unsigned> cabeca(0);
+std::atomic<unsigned> cauda(0);
+std::atomic<uint64_t> descartados(0);
+
+int pinoBotao = -1;
+int64_t debounceNs = 0;
+int64_t ultimaBordaNs = 0;
+bool nivelAposBorda = true;  // lido depois da ultima borda; HIGH = solto
+int fdEvento = -1;
+std::atomic<bool> parado(false);
+
+std::mutex mtxCallback;
+CallbackBotao callbackBotao;
+
+bool retirar(EventoBotao& evento) {
+    unsigned c = cauda.load(std::memory_order_relaxed);
+    if (c == cabeca.load(std::memory_order_acquire)) return false;
+    evento = fila[c % TAMANHO_FILA];
+    cauda.store(c + 1, std::memory_order_release);
+    return true;
+}
+
+void tratarInterrupcao() {
+    int64_t agora = agoraNs();
+    bool nivel = gpio().ler(pinoBotao);
+
+    // Debounce por estado: a linha so e estavel depois de debounceNs sem
+    // bordas, no nivel lido apos a ultima delas. A primeira borda depois de
+    // um periodo estavel em HIGH e um clique, mesmo que o pino ja tenha
+    // voltado a HIGH (toque curto). Um repique de soltura, por mais tarde que
+    // venha, encontra a linha estavel em LOW ou ainda instavel e nao conta.
+    bool estavel = agora - ultimaBordaNs >= debounceNs;
+    bool soltoAntes = nivelAposBorda;
+    ultimaBordaNs = agora;
+    nivelAposBorda = nivel;
+    if (!estavel || !soltoAntes) return;
+
+    EventoBotao evento{pinoBotao, agora};
+
+    // Copia sob o lock e chama fora dele: o callback pode trocar a si mesmo
+    CallbackBotao callback;
+    {
+        std::lock_guard<std::mutex> lock(mtxCallback);
+        callback = callbackBotao;
+    }
+    if (callback) {
+        callback(evento);
+        return;
+    }
+
+    unsigned h = cabeca.load(std::memory_order_relaxed);
+    if (h - cauda.load(std::memory_order_acquire) >= TAMANHO_FILA) {
+        descartados++;
+        return;
+    }
+    fila[h % TAMANHO_FILA] = evento;
+    cabeca.store(h + 1, std::memory_order_release);
+
+    uint64_t um = 1;
+    (void)!write(fdEvento, &um, sizeof(um));
+}
+
+}  // namespace
+
+bool iniciarEventosBotao(int pino, int debounceMs) {
+    if (fdEvento < 0) {
+        fdEvento = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (fdEvento < 0) return false;
+    }
+
+    pinoBotao = pino;
+    debounceNs = static_cast<int64_t>(debounceMs) * 1000000LL;
+    ultimaBordaNs = 0;
+    nivelAposBorda = true;
+    parado = false;
+
+    return gpio().registrarInterrupcao(pino, Borda::Ambas, &tratarInterrupcao);
+}
+
+void registrarCallbackBotao(CallbackBotao callback) {
+    std::lock_guard<std::mutex> lock(mtxCallback);
+    callbackBotao = std::move(callback);
+}
+
+bool aguardarEventoBotao(EventoBotao& evento, int timeoutMs) {
+    int64_t limite = timeoutMs < 0 ? -1 : agoraNs() + static_cast<int64_t>(timeoutMs) * 1000000LL;
+
+    while (!parado) {
+        if (retirar(evento)) return true;
+
+        int espera = -1;
+        if (limite >= 0) {
+            int64_t restante = limite - agoraNs();
+            espera = restante > 0 ? static_cast<int>((restante + 999999) / 1000000) : 0;
+        }
+
+        // Sempre consome o eventfd, mesmo com timeout 0: quem usa epoll
+        // drena a fila assim e o fd nao fica legivel para sempre
+        pollfd pfd{fdEvento, POLLIN, 0};
+        if (poll(&pfd, 1, espera) > 0) {
+            uint64_t contador;
+            (void)!read(fdEvento, &contador, sizeof(contador));
+        } else if (espera >= 0) {
+            return retirar(evento);
+        }
+    }
+    return false;
+}
+
+int fdEventosBotao() {
+    return fdEvento;
+}
+
+void pararEventosBotao() {
+    parado = true;
+    if (fdEvento >= 0) {
+        uint64_t um = 1;
+        (void)!write(fdEvento, &um, sizeof(um));
+    }
+}
+
+uint64_t eventosBotaoDescartados() {
+    return descartados;
+}
@@ -1,9 +1,12 @@
 #include "camera.h"
-#include <iostream>
+#include "classificador.h"
+#include "log.h"
+#include "metricas.h"
+#include <utility>
 
 bool openCamera(cv::VideoCapture& cap, int device) {
     if (!cap.open(device)) {
-        std::cerr << "Erro ao abrir a camera no dispositivo " << device << std::endl;
+        LOG_ERRO("Erro ao abrir a camera no dispositivo {}", device);
         return false;
     }
     return true;
@@ -19,41 +22,127 @@ std::string detectColorRGB(const cv::Vec3b& pixel) {
     int g = pixel[1];
     int r = pixel[2];
 
-    if (r > 200 && g < 80 && b < 80) return "Vermelho";
-    if (g > 200 && r < 80 && b < 80) return "Verde";
-    if (b > 200 && r < 80 && g < 80) return "Azul";
-    if (r > 200 && g > 200 && b < 80) return "Amarelo";
-    if (r > 200 && g > 100 && b > 100) return "Rosa";
-    if (r < 50 && g < 50 && b < 50) return "Preto";
-    if (r > 200 && g > 200 && b > 200) return "Branco";
-    return "Indefinido";
+    return nomeCor(corReferenciaRGB(r, g, b));
 }
 
-std::string processFrame(cv::VideoCapture& cap, int& r, int& g, int& b) {
-    static std::string ultimaCor;
-
-    cv::Mat frame;
-    cap >> frame;
-    if (frame.empty()) return "";
+cv::Rect centralROI(const cv::Mat& frame, int tamanho) {
+    return centralROI(cv::Size(frame.cols, frame.rows), tamanho);
+}
 
-    int rectSize = 20;
-    int x = frame.cols / 2;
-    int y = frame.rows / 2;
-    cv::Rect roi(x - rectSize / 2, y - rectSize / 2, rectSize, rectSize);
+cv::Rect centralROI(cv::Size size, int tamanho) {
+    int x = size.width / 2;
+    int y = size.height / 2;
+    // Recortada ao quadro: ROI maior que a imagem (ou resolucao minuscula) nao le fora do buffer
+    return cv::Rect(x - tamanho / 2, y - tamanho / 2, tamanho, tamanho) & cv::Rect(0, 0, size.width, size.height);
+}
 
-    cv::Mat region = frame(roi);
-    cv::Scalar meanColor = cv::mean(region);
+std::string analisarROI(const cv::Mat& frame, const cv::Rect& roi, int& r, int& g, int& b) {
+    cv::Scalar meanColor = cv::mean(frame(roi));
 
     b = static_cast<int>(meanColor[0]);
     g = static_cast<int>(meanColor[1]);
     r = static_cast<int>(meanColor[2]);
 
-    std::string cor = detectColorRGB(cv::Vec3b(b, g, r));
+    return detectColorRGB(cv::Vec3b(b, g, r));
+}
+
+std::string processFrame(cv::VideoCapture& cap, int& r, int& g, int& b) {
+    static std::string ultimaCor;
+
+    cv::Mat frame;
+    cap >> frame;
+    if (frame.empty()) return "";
+
+    std::string cor = analisarROI(frame, centralROI(frame), r, g, b);
 
     if (cor != ultimaCor) {
-        std::cout << "Cor detectada: " << cor << std::endl;
+        LOG_INFO("Cor detectada: {}", cor);
         ultimaCor = cor;
     }
 
     return cor;
 }
+
+namespace {
+
+class VideoCaptureSource : public FrameSource {
+public:
+    explicit VideoCaptureSource(const CameraConfig& config) : config_(config) {}
+
+    bool open() override {
+        if (!openCamera(cap_, config_.device)) return false;
+        cap_.set(cv::CAP_PROP_FRAME_WIDTH, config_.width);
+        cap_.set(cv::CAP_PROP_FRAME_HEIGHT, config_.height);
+        cap_.set(cv::CAP_PROP_BUFFERSIZE, 1);
+        return true;
+    }
+
+    bool grab(Frame& frame) override {
+        if (!cap_.read(buffer_) || buffer_.empty()) return false;
+        frame.timestampNs = agoraNs();
+
+        {
+            MedirEstagio medir(Estagio::ROI);
+            frame.roi = centralROI(buffer_, config_.roiSize);
+            buffer_(frame.roi).copyTo(frame.roiBGR);
+            frame.roiMedia = cv::mean(frame.roiBGR);
+        }
+
+        // Troca os buffers: o quadro vai para o Frame e o antigo e reaproveitado na proxima leitura
+        if (config_.copyFrame) {
+            std::swap(frame.imagem, buffer_);
+            frame.bruto = frame.imagem.data;
+        } else {
+            frame.imagem.release();
+            frame.bruto = buffer_.data;
+        }
+        frame.brutoStride = frame.imagem.empty() ? buffer_.step : frame.imagem.step;
+        frame.brutoFormato = PixelFormat::BGR;
+        frame.brutoTamanho = config_.copyFrame ? frame.imagem.size() : buffer_.size();
+        return true;
+    }
+
+    void close() override {
+        cap_.release();
+    }
+
+    const char* name() const override { return "VideoCapture"; }
+
+private:
+    CameraConfig config_;
+    cv::VideoCapture cap_;
+    cv::Mat buffer_;
+};
+
+}  // namespace
+
+std::unique_ptr<FrameSource> createVideoCaptureSource(const CameraConfig& config) {
+    return std::unique_ptr<FrameSource>(new VideoCaptureSource(config));
+}
+
+std::unique_ptr<FrameSource> openCamera(const CameraConfig& config) {
+    std::unique_ptr<FrameSource> source;
+
+    if (!config.replayFile.empty()) {
+        source = createReplaySource(config);
+        if (source->open()) return source;
+        return nullptr;
+    }
+
+    if (!config.fakeFile.empty()) {
+        source = createRawFileSource(config);
+        if (source->open()) return source;
+        return nullptr;
+    }
+
+    // V4L2 so entrega formatos crus (YUYV/GREY); BGR vai direto para o VideoCapture
+    if (config.format != PixelFormat::BGR) {
+        source = createV4L2Source(config);
+        if (source->open()) return source;
+        LOG_AVISO("V4L2 indisponivel, usando cv::VideoCapture");
+    }
+
+    source = createVideoCaptureSource(config);
+    if (source->open()) return source;
+    return nullptr;
+}
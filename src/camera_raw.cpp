@@ -0,0 +1,176 @@
+// camera_raw.cpp
+#include "camera.h"
+#include "log.h"
+#include "metricas.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+size_t rawFrameSize(PixelFormat format, int width, int height) {
+    switch (format) {
+        case PixelFormat::YUYV: return static_cast<size_t>(width) * height * 2;
+        case PixelFormat::GREY: return static_cast<size_t>(width) * height;
+        case PixelFormat::BGR:  return static_cast<size_t>(width) * height * 3;
+    }
+    return 0;
+}
+
+static inline uint8_t saturar(int v) {
+    return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+void extractRawROI(const uint8_t* data, size_t stride, PixelFormat format, const cv::Rect& roi,
+                   cv::Mat& roiBGR, cv::Scalar& media) {
+    MedirEstagio medir(Estagio::ROI);
+    roiBGR.create(roi.height, roi.width, CV_8UC3);
+    long soma[3] = {0, 0, 0};
+
+    for (int y = 0; y < roi.height; y++) {
+        const uint8_t* linha = data + static_cast<size_t>(roi.y + y) * stride;
+        uint8_t* saida = roiBGR.ptr<uint8_t>(y);
+
+        for (int x = 0; x < roi.width; x++) {
+            int px = roi.x + x;
+            uint8_t b, g, r;
+
+            if (format == PixelFormat::YUYV) {
+                // Y0 U Y1 V: cada par de pixels divide o mesmo U/V. BT.601 faixa
+                // limitada, como o COLOR_YUV2BGR_YUYV do OpenCV, em ponto fixo Q10
+                const uint8_t* par = linha + (px & ~1) * 2;
+                int luma = 1192 * std::max(0, linha[px * 2] - 16);
+                int d = par[1] - 128;
+                int e = par[3] - 128;
+                r = saturar((luma + 1634 * e + 512) >> 10);
+                g = saturar((luma - 400 * d - 833 * e + 512) >> 10);
+                b = saturar((luma + 2066 * d + 512) >> 10);
+            } else if (format == PixelFormat::GREY) {
+                b = g = r = linha[px];
+            } else {
+                b = linha[px * 3];
+                g = linha[px * 3 + 1];
+                r = linha[px * 3 + 2];
+            }
+
+            saida[x * 3] = b;
+            saida[x * 3 + 1] = g;
+            saida[x * 3 + 2] = r;
+            soma[0] += b;
+            soma[1] += g;
+            soma[2] += r;
+        }
+    }
+
+    double n = std::max(1, roi.area());
+    media = cv::Scalar(soma[0] / n, soma[1] / n, soma[2] / n);
+}
+
+void convertRawToBGR(const uint8_t* data, size_t stride, PixelFormat format, int width, int height,
+                     cv::Mat& bgr) {
+    uint8_t* ptr = const_cast<uint8_t*>(data);
+    switch (format) {
+        case PixelFormat::YUYV:
+            cv::cvtColor(cv::Mat(height, width, CV_8UC2, ptr, stride), bgr, cv::COLOR_YUV2BGR_YUYV);
+            break;
+        case PixelFormat::GREY:
+            cv::cvtColor(cv::Mat(height, width, CV_8UC1, ptr, stride), bgr, cv::COLOR_GRAY2BGR);
+            break;
+        case PixelFormat::BGR:
+            cv::Mat(height, width, CV_8UC3, ptr, stride).copyTo(bgr);
+            break;
+    }
+}
+
+namespace {
+
+// Dispositivo fake para testes: arquivo com quadros crus concatenados, lido
+// via mmap e repetido em loop no ritmo de fakeFps
+class RawFileSource : public FrameSource {
+public:
+    explicit RawFileSource(const CameraConfig& config) : config_(config) {}
+
+    ~RawFileSource() override {
+        close();
+    }
+
+    bool open() override {
+        int fd = ::open(config_.fakeFile.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            LOG_ERRO("Erro ao abrir arquivo de quadros {}", config_.fakeFile);
+            return false;
+        }
+
+        struct stat st;
+        frameSize_ = rawFrameSize(config_.format, config_.width, config_.height);
+        if (fstat(fd, &st) < 0 || frameSize_ == 0 || static_cast<size_t>(st.st_size) < frameSize_) {
+            LOG_ERRO("Arquivo de quadros menor que um quadro {}x{}", config_.width, config_.height);
+            ::close(fd);
+            return false;
+        }
+
+        length_ = st.st_size;
+        void* map = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return false;
+
+        data_ = static_cast<const uint8_t*>(map);
+        frames_ = length_ / frameSize_;
+        next_ = 0;
+        proximoQuadro_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    bool grab(Frame& frame) override {
+        if (!data_) return false;
+
+        if (config_.fakeFps > 0) {
+            std::this_thread::sleep_until(proximoQuadro_);
+            proximoQuadro_ += std::chrono::microseconds(1000000 / config_.fakeFps);
+        }
+
+        const uint8_t* quadro = data_ + (next_ % frames_) * frameSize_;
+        next_++;
+
+        size_t stride = rawFrameSize(config_.format, config_.width, 1);
+        frame.timestampNs = agoraNs();
+        frame.roi = centralROI(cv::Size(config_.width, config_.height), config_.roiSize);
+        extractRawROI(quadro, stride, config_.format, frame.roi, frame.roiBGR, frame.roiMedia);
+
+        if (config_.copyFrame) {
+            convertRawToBGR(quadro, stride, config_.format, config_.width, config_.height, frame.imagem);
+        } else {
+            frame.imagem.release();
+        }
+
+        frame.bruto = quadro;
+        frame.brutoStride = stride;
+        frame.brutoFormato = config_.format;
+        frame.brutoTamanho = cv::Size(config_.width, config_.height);
+        return true;
+    }
+
+    void close() override {
+        if (data_) munmap(const_cast<uint8_t*>(data_), length_);
+        data_ = nullptr;
+    }
+
+    const char* name() const override { return "arquivo"; }
+
+private:
+    CameraConfig config_;
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+    size_t frameSize_ = 0;
+    size_t frames_ = 0;
+    size_t next_ = 0;
+    std::chrono::steady_clock::time_point proximoQuadro_;
+};
+
+}  // namespace
+
+std::unique_ptr<FrameSource> createRawFileSource(const CameraConfig& config) {
+    return std::unique_ptr<FrameSource>(new RawFileSource(config));
+}
@@ -0,0 +1,106 @@
+// camera_replay.cpp
+#include "camera.h"
+#include "frame_recorder.h"
+#include "metricas.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+
+// Intervalo maximo reproduzido entre dois quadros. A gravacao atravessa as
+// ativacoes, entao um buraco maior e o sistema inativo: o replay continua
+// dali como uma nova referencia em vez de dormir minutos dentro do grab()
+constexpr int64_t MAX_INTERVALO_NS = 500000000;
+
+// Reproduz uma gravacao (.rec) pelo mesmo caminho das fontes reais: ROI e
+// conversao saem do buffer mmap do arquivo. No ritmo gravado (intervalos
+// entre timestamps originais) ou o mais rapido possivel.
+class ReplaySource : public FrameSource {
+public:
+    explicit ReplaySource(const CameraConfig& config) : config_(config) {}
+
+    ~ReplaySource() override {
+        close();
+    }
+
+    bool open() override {
+        if (!reader_.open(config_.replayFile) || reader_.frames().empty()) return false;
+        next_ = 0;
+        std::lock_guard<std::mutex> lock(mtx_);
+        interrompido_ = false;
+        return true;
+    }
+
+    bool grab(Frame& frame) override {
+        const std::vector<RecordingReader::QuadroGravado>& quadros = reader_.frames();
+        if (quadros.empty()) return false;
+        if (next_ >= quadros.size()) {
+            if (!config_.replayLoop) return false;
+            next_ = 0;
+        }
+        const RecordingReader::QuadroGravado& quadro = quadros[next_];
+
+        // Reinicia a referencia de tempo no primeiro quadro de cada volta e
+        // depois de cada intervalo entre ativacoes
+        if (config_.replayRealtime) {
+            if (next_ == 0 || quadro.timestampNs - anteriorGravado_ > MAX_INTERVALO_NS) {
+                inicioGravado_ = quadro.timestampNs;
+                inicioReal_ = std::chrono::steady_clock::now();
+            }
+            anteriorGravado_ = quadro.timestampNs;
+            auto prazo = inicioReal_ + std::chrono::nanoseconds(quadro.timestampNs - inicioGravado_);
+            std::unique_lock<std::mutex> lock(mtx_);
+            if (cv_.wait_until(lock, prazo, [this] { return interrompido_; })) return false;
+        }
+        next_++;
+
+        cv::Size tamanho = reader_.size();
+        frame.timestampNs = agoraNs();
+        frame.roi = centralROI(tamanho, config_.roiSize);
+        extractRawROI(quadro.dados, reader_.stride(), reader_.format(), frame.roi, frame.roiBGR, frame.roiMedia);
+
+        if (config_.copyFrame) {
+            convertRawToBGR(quadro.dados, reader_.stride(), reader_.format(), tamanho.width, tamanho.height,
+                            frame.imagem);
+        } else {
+            frame.imagem.release();
+        }
+
+        frame.bruto = quadro.dados;
+        frame.brutoStride = reader_.stride();
+        frame.brutoFormato = reader_.format();
+        frame.brutoTamanho = tamanho;
+        return true;
+    }
+
+    void interromper() override {
+        std::lock_guard<std::mutex> lock(mtx_);
+        interrompido_ = true;
+        cv_.notify_all();
+    }
+
+    void close() override {
+        reader_.close();
+    }
+
+    const char* name() const override { return "gravacao"; }
+
+private:
+    CameraConfig config_;
+    RecordingReader reader_;
+    size_t next_ = 0;
+    int64_t inicioGravado_ = 0;
+    int64_t anteriorGravado_ = 0;
+    std::chrono::steady_clock::time_point inicioReal_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool interrompido_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<FrameSource> createReplaySource(const CameraConfig& config) {
+    return std::unique_ptr<FrameSource>(new ReplaySource(config));
+}
@@ -0,0 +1,195 @@
+// camera_v4l2.cpp
+#include "camera.h"
+#include "log.h"
+#include "metricas.h"
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+namespace {
+
+int xioctl(int fd, unsigned long request, void* arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r < 0 && errno == EINTR);
+    return r;
+}
+
+// Captura por streaming I/O: os quadros ficam nos buffers mmap do kernel e a
+// ROI e lida direto deles. O buffer so volta para a fila do driver no proximo
+// grab(), para Frame::bruto continuar valido ate la (gravacao)
+class V4L2Source : public FrameSource {
+public:
+    explicit V4L2Source(const CameraConfig& config)
+        : config_(config), fdInterromper_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+
+    ~V4L2Source() override {
+        close();
+        if (fdInterromper_ >= 0) ::close(fdInterromper_);
+    }
+
+    bool open() override {
+        std::string path = "/dev/video" + std::to_string(config_.device);
+        fd_ = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd_ < 0) return false;
+
+        v4l2_format fmt{};
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        fmt.fmt.pix.width = config_.width;
+        fmt.fmt.pix.height = config_.height;
+        fmt.fmt.pix.pixelformat = config_.format == PixelFormat::GREY ? V4L2_PIX_FMT_GREY : V4L2_PIX_FMT_YUYV;
+        fmt.fmt.pix.field = V4L2_FIELD_NONE;
+        unsigned pedido = fmt.fmt.pix.pixelformat;
+
+        // O driver pode trocar o formato por outro que ele suporte: nesse caso desiste
+        if (xioctl(fd_, VIDIOC_S_FMT, &fmt) < 0 || fmt.fmt.pix.pixelformat != pedido) {
+            LOG_AVISO("V4L2: formato nao suportado em {}", path);
+            close();
+            return false;
+        }
+        width_ = fmt.fmt.pix.width;
+        height_ = fmt.fmt.pix.height;
+        stride_ = fmt.fmt.pix.bytesperline ? fmt.fmt.pix.bytesperline
+                                           : rawFrameSize(config_.format, width_, 1);
+
+        v4l2_requestbuffers req{};
+        req.count = config_.buffers;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(fd_, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+            LOG_AVISO("V4L2: sem buffers mmap suficientes");
+            close();
+            return false;
+        }
+
+        for (unsigned i = 0; i < req.count; i++) {
+            v4l2_buffer buf{};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = i;
+            if (xioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0) {
+                close();
+                return false;
+            }
+
+            void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+            if (start == MAP_FAILED) {
+                close();
+                return false;
+            }
+            buffers_.push_back({static_cast<uint8_t*>(start), buf.length});
+
+            if (xioctl(fd_, VIDIOC_QBUF, &buf) < 0) {
+                close();
+                return false;
+            }
+        }
+
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (xioctl(fd_, VIDIOC_STREAMON, &type) < 0) {
+            close();
+            return false;
+        }
+        streaming_ = true;
+        return true;
+    }
+
+    bool grab(Frame& frame) override {
+        if (fd_ < 0) return false;
+
+        if (pendente_ >= 0) {
+            v4l2_buffer anterior{};
+            anterior.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            anterior.memory = V4L2_MEMORY_MMAP;
+            anterior.index = static_cast<unsigned>(pendente_);
+            pendente_ = -1;
+            if (xioctl(fd_, VIDIOC_QBUF, &anterior) < 0) return false;
+        }
+
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        while (xioctl(fd_, VIDIOC_DQBUF, &buf) < 0) {
+            if (errno != EAGAIN) return false;
+            pollfd pfds[] = {{fd_, POLLIN, 0}, {fdInterromper_, POLLIN, 0}};
+            if (poll(pfds, 2, 1000) <= 0 || pfds[1].revents) return false;
+        }
+
+        const uint8_t* data = buffers_[buf.index].start;
+        if (buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+            frame.timestampNs = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000000LL +
+                                static_cast<int64_t>(buf.timestamp.tv_usec) * 1000LL;
+        } else {
+            frame.timestampNs = agoraNs();
+        }
+
+        frame.roi = centralROI(cv::Size(width_, height_), config_.roiSize);
+        extractRawROI(data, stride_, config_.format, frame.roi, frame.roiBGR, frame.roiMedia);
+
+        if (config_.copyFrame) {
+            convertRawToBGR(data, stride_, config_.format, width_, height_, frame.imagem);
+        } else {
+            frame.imagem.release();
+        }
+
+        frame.bruto = data;
+        frame.brutoStride = stride_;
+        frame.brutoFormato = config_.format;
+        frame.brutoTamanho = cv::Size(width_, height_);
+        pendente_ = static_cast<int>(buf.index);
+        return true;
+    }
+
+    // O eventfd nunca e lido: depois de interrompida, todo grab() que
+    // precisaria esperar retorna false na hora
+    void interromper() override {
+        uint64_t um = 1;
+        (void)!write(fdInterromper_, &um, sizeof(um));
+    }
+
+    void close() override {
+        if (fd_ < 0) return;
+        if (streaming_) {
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            xioctl(fd_, VIDIOC_STREAMOFF, &type);
+            streaming_ = false;
+        }
+        pendente_ = -1;
+        for (const Buffer& b : buffers_) munmap(b.start, b.length);
+        buffers_.clear();
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    const char* name() const override { return "V4L2"; }
+
+private:
+    struct Buffer {
+        uint8_t* start;
+        size_t length;
+    };
+
+    CameraConfig config_;
+    int fd_ = -1;
+    int fdInterromper_;
+    bool streaming_ = false;
+    int width_ = 0;
+    int height_ = 0;
+    size_t stride_ = 0;
+    std::vector<Buffer> buffers_;
+    int pendente_ = -1;  // buffer entregue no ultimo grab(), ainda fora da fila
+};
+
+}  // namespace
+
+std::unique_ptr<FrameSource> createV4L2Source(const CameraConfig& config) {
+    return std::unique_ptr<FrameSource>(new V4L2Source(config));
+}
@@ -0,0 +1,237 @@
+// classificador.cpp
+#include "classificador.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+const char* nomeCor(Cor cor) {
+    switch (cor) {
+        case Cor::Vermelho: return "Vermelho";
+        case Cor::Verde:    return "Verde";
+        case Cor::Azul:     return "Azul";
+        case Cor::Amarelo:  return "Amarelo";
+        case Cor::Rosa:     return "Rosa";
+        case Cor::Preto:    return "Preto";
+        case Cor::Branco:   return "Branco";
+        case Cor::Cinza:    return "Cinza";
+        case Cor::Ciano:    return "Ciano";
+        case Cor::Roxo:     return "Roxo";
+        default:            return "Indefinido";
+    }
+}
+
+Cor corReferenciaRGB(int r, int g, int b) {
+    if (r > 200 && g < 80 && b < 80) return Cor::Vermelho;
+    if (g > 200 && r < 80 && b < 80) return Cor::Verde;
+    if (b > 200 && r < 80 && g < 80) return Cor::Azul;
+    if (r > 200 && g > 200 && b < 80) return Cor::Amarelo;
+    if (r > 200 && g > 100 && b > 100) return Cor::Rosa;
+    if (r < 50 && g < 50 && b < 50) return Cor::Preto;
+    if (r > 200 && g > 200 && b > 200) return Cor::Branco;
+    return Cor::Indefinido;
+}
+
+Cor corReferenciaHSV(int h, int s, int v) {
+    // Tons acromaticos primeiro: dependem de saturacao e valor, nao de matiz
+    if (v < 30) return Cor::Preto;
+    if (s < 20 && v > 220) return Cor::Branco;
+    if (s < 30 && v >= 30 && v <= 220) return Cor::Cinza;
+
+    // Cores cromaticas exigem saturacao e brilho minimos
+    if (s < 60 || v < 60) return Cor::Indefinido;
+
+    if ((h >= 0 && h <= 8) || (h >= 170 && h <= 179)) return Cor::Vermelho;
+    if (h >= 18 && h <= 30) return Cor::Amarelo;
+    if (h >= 45 && h <= 75) return Cor::Verde;
+    if (h >= 85 && h <= 95) return Cor::Ciano;
+    if (h >= 105 && h <= 130) return Cor::Azul;
+    if (h >= 140 && h <= 160) return Cor::Roxo;
+    return Cor::Indefinido;
+}
+
+void bgrParaHSV(int b, int g, int r, int& h, int& s, int& v) {
+    int maximo = std::max(r, std::max(g, b));
+    int minimo = std::min(r, std::min(g, b));
+    int diff = maximo - minimo;
+
+    v = maximo;
+    s = maximo == 0 ? 0 : static_cast<int>(std::lround(diff * 255.0 / maximo));
+
+    if (diff == 0) {
+        h = 0;
+        return;
+    }
+
+    double graus;
+    if (maximo == r) graus = 60.0 * (g - b) / diff;
+    else if (maximo == g) graus = 120.0 + 60.0 * (b - r) / diff;
+    else graus = 240.0 + 60.0 * (r - g) / diff;
+    if (graus < 0) graus += 360.0;
+
+    h = static_cast<int>(std::lround(graus / 2.0)) % 180;
+}
+
+ClassificadorCor::ClassificadorCor(RegrasCor regras) : regras_(regras) {
+    for (int c = 0; c < 3; c++) {
+        if (regras == RegrasCor::RGB) {
+            // Limiares das regras RGB (x < 50, x < 80, x > 100, x > 200): com as
+            // faixas alinhadas a eles a tabela reproduz a referencia exatamente
+            limites_[c] = {50, 80, 101, 201};
+        } else {
+            for (int v = 8; v < 256; v += 8) limites_[c].push_back(static_cast<uint8_t>(v));
+        }
+        niveis_[c] = static_cast<int>(limites_[c].size()) + 1;
+
+        for (int v = 0; v < 256; v++) {
+            int faixa = 0;
+            for (uint8_t limite : limites_[c]) faixa += v >= limite;
+            quant_[c][v] = static_cast<uint8_t>(faixa);
+        }
+    }
+
+    // Representante de cada faixa: o ponto medio dela
+    auto representante = [this](int c, int faixa) {
+        int inicio = faixa == 0 ? 0 : limites_[c][faixa - 1];
+        int fim = faixa + 1 < niveis_[c] ? limites_[c][faixa] - 1 : 255;
+        return (inicio + fim) / 2;
+    };
+
+    tabela_.resize(niveis_[0] * niveis_[1] * niveis_[2]);
+    for (int qb = 0; qb < niveis_[0]; qb++) {
+        for (int qg = 0; qg < niveis_[1]; qg++) {
+            for (int qr = 0; qr < niveis_[2]; qr++) {
+                int b = representante(0, qb);
+                int g = representante(1, qg);
+                int r = representante(2, qr);
+
+                Cor cor;
+                if (regras == RegrasCor::RGB) {
+                    cor = corReferenciaRGB(r, g, b);
+                } else {
+                    int h, s, v;
+                    bgrParaHSV(b, g, r, h, s, v);
+                    cor = corReferenciaHSV(h, s, v);
+                }
+                tabela_[(qb * niveis_[1] + qg) * niveis_[2] + qr] = cor;
+            }
+        }
+    }
+}
+
+// Indices na tabela para 16 pixels BGR consecutivos. A faixa de cada canal e
+// o numero de limites <= valor, contado com comparacoes vetoriais
+void ClassificadorCor::indices16(const uint8_t* bgr, uint16_t* indices) const {
+#if defined(__ARM_NEON)
+    uint8x16x3_t px = vld3q_u8(bgr);
+    uint8x16_t q[3];
+    for (int c = 0; c < 3; c++) {
+        uint8x16_t acc = vdupq_n_u8(0);
+        for (uint8_t limite : limites_[c]) {
+            acc = vsubq_u8(acc, vcgeq_u8(px.val[c], vdupq_n_u8(limite)));  // 0xFF = -1
+        }
+        q[c] = acc;
+    }
+
+    uint16_t passoB = static_cast<uint16_t>(niveis_[1] * niveis_[2]);
+    uint8x8_t passoG = vdup_n_u8(static_cast<uint8_t>(niveis_[2]));
+
+    uint16x8_t lo = vmulq_n_u16(vmovl_u8(vget_low_u8(q[0])), passoB);
+    lo = vmlal_u8(lo, vget_low_u8(q[1]), passoG);
+    lo = vaddw_u8(lo, vget_low_u8(q[2]));
+    uint16x8_t hi = vmulq_n_u16(vmovl_u8(vget_high_u8(q[0])), passoB);
+    hi = vmlal_u8(hi, vget_high_u8(q[1]), passoG);
+    hi = vaddw_u8(hi, vget_high_u8(q[2]));
+
+    vst1q_u16(indices, lo);
+    vst1q_u16(indices + 8, hi);
+#elif defined(__SSE2__)
+    // SSE2 nao tem load com desentrelacamento de 3 canais: separa os planos antes
+    alignas(16) uint8_t planos[3][16];
+    for (int i = 0; i < 16; i++) {
+        planos[0][i] = bgr[i * 3];
+        planos[1][i] = bgr[i * 3 + 1];
+        planos[2][i] = bgr[i * 3 + 2];
+    }
+
+    __m128i zero = _mm_setzero_si128();
+    __m128i q[3];
+    for (int c = 0; c < 3; c++) {
+        __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(planos[c]));
+        __m128i acc = zero;
+        for (uint8_t limite : limites_[c]) {
+            // v >= limite (sem sinal) <=> max(v, limite) == v
+            __m128i ge = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(static_cast<char>(limite))), v);
+            acc = _mm_sub_epi8(acc, ge);
+        }
+        q[c] = acc;
+    }
+
+    __m128i passoB = _mm_set1_epi16(static_cast<short>(niveis_[1] * niveis_[2]));
+    __m128i passoG = _mm_set1_epi16(static_cast<short>(niveis_[2]));
+
+    __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(q[0], zero), passoB);
+    lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(q[1], zero), passoG));
+    lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(q[2], zero));
+    __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(q[0], zero), passoB);
+    hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(q[1], zero), passoG));
+    hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(q[2], zero));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices + 8), hi);
+#else
+    for (int i = 0; i < 16; i++) {
+        const uint8_t* p = bgr + i * 3;
+        indices[i] = static_cast<uint16_t>((quant_[0][p[0]] * niveis_[1] + quant_[1][p[1]]) * niveis_[2] +
+                                           quant_[2][p[2]]);
+    }
+#endif
+}
+
+ResultadoCor ClassificadorCor::votar(const cv::Mat& bgr) const {
+    ResultadoCor resultado;
+    if (bgr.empty()) return resultado;
+
+    uint16_t indices[16];
+    for (int y = 0; y < bgr.rows; y++) {
+        const uint8_t* linha = bgr.ptr<uint8_t>(y);
+        int x = 0;
+        for (; x + 16 <= bgr.cols; x += 16) {
+            indices16(linha + x * 3, indices);
+            for (int i = 0; i < 16; i++) {
+                resultado.votos[static_cast<int>(tabela_[indices[i]])]++;
+            }
+        }
+        for (; x < bgr.cols; x++) {
+            const uint8_t* p = linha + x * 3;
+            resultado.votos[static_cast<int>(classificar(p[0], p[1], p[2]))]++;
+        }
+    }
+
+    resultado.total = bgr.rows * bgr.cols;
+    if (resultado.total == 0) return resultado;  // ROI recortada a nada: Indefinido
+    int vencedora = static_cast<int>(std::max_element(resultado.votos, resultado.votos + NUM_CORES) -
+                                     resultado.votos);
+    resultado.cor = static_cast<Cor>(vencedora);
+    resultado.confianca = static_cast<float>(resultado.votos[vencedora]) / resultado.total;
+    return resultado;
+}
+
+void ClassificadorCor::classificarLinha(const uint8_t* bgr, int n, uint8_t* classes) const {
+    uint16_t indices[16];
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        indices16(bgr + x * 3, indices);
+        for (int i = 0; i < 16; i++) {
+            classes[x + i] = static_cast<uint8_t>(tabela_[indices[i]]);
+        }
+    }
+    for (; x < n; x++) {
+        const uint8_t* p = bgr + x * 3;
+        classes[x] = static_cast<uint8_t>(classificar(p[0], p[1], p[2]));
+    }
+}
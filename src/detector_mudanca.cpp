@@ -0,0 +1,103 @@
+// detector_mudanca.cpp
+#include "detector_mudanca.h"
+#include "metricas.h"
+#include <algorithm>
+#include <cstdlib>
+
+DetectorMudanca::DetectorMudanca(int limiar, int intervaloMaximo)
+    : limiar_(limiar), intervaloMaximo_(intervaloMaximo) {}
+
+bool DetectorMudanca::precisaClassificar(const cv::Mat& imagem) {
+    avaliados_++;
+    if (imagem.empty()) return true;
+    int64_t inicio = agoraNs();
+    bool mudou = compararAssinatura(imagem);
+    custoPorteiroNs_ += agoraNs() - inicio;
+
+    if (!mudou && ++semMudanca_ < intervaloMaximo_) {
+        pulados_++;
+        return false;
+    }
+    semMudanca_ = 0;
+    return true;
+}
+
+bool DetectorMudanca::compararAssinatura(const cv::Mat& imagem) {
+    // Blocos de pelo menos ~5 px: a ROI de 20x20 vira 4x4, o quadro 640x480 vira 16x12
+    int gradeX = std::max(1, std::min(16, imagem.cols / 5));
+    int gradeY = std::max(1, std::min(12, imagem.rows / 5));
+    int passo = std::max(1, std::min(imagem.rows, imagem.cols) / 120);
+
+    atual_.assign(gradeX * gradeY, 0);
+    amostras_.assign(gradeX * gradeY, 0);
+    for (int y = 0; y < imagem.rows; y += passo) {
+        const uint8_t* linha = imagem.ptr<uint8_t>(y);
+        int by = y * gradeY / imagem.rows;
+        for (int x = 0; x < imagem.cols; x += passo) {
+            const uint8_t* p = linha + x * 3;
+            int bloco = by * gradeX + x * gradeX / imagem.cols;
+            atual_[bloco] += p[0] + 2 * p[1] + p[2];  // luma aproximada x4
+            amostras_[bloco]++;
+        }
+    }
+    for (size_t i = 0; i < atual_.size(); i++) {
+        atual_[i] /= 4 * std::max(1, amostras_[i]);
+    }
+    tamanhoAtual_ = cv::Size(gradeX, gradeY);
+
+    bool mudou = tamanhoAtual_.width != tamanhoReferencia_.width ||
+                 tamanhoAtual_.height != tamanhoReferencia_.height;
+    for (size_t i = 0; !mudou && i < atual_.size(); i++) {
+        mudou = std::abs(atual_[i] - referencia_[i]) > limiar_;
+    }
+    return mudou;
+}
+
+void DetectorMudanca::aceitar() {
+    referencia_ = atual_;
+    tamanhoReferencia_ = tamanhoAtual_;
+}
+
+void DetectorMudanca::registrarCusto(int64_t ns) {
+    custoTotalNs_ += ns;
+    classificacoes_++;
+}
+
+double DetectorMudanca::economiaMs() const {
+    if (classificacoes_ == 0) return 0.0;
+    double custoMedioNs = static_cast<double>(custoTotalNs_) / classificacoes_;
+    return (pulados_ * custoMedioNs - custoPorteiroNs_) / 1e6;
+}
+
+HistereseCor::HistereseCor(int confirmacoes, float confiancaMinima)
+    : confirmacoes_(confirmacoes), confiancaMinima_(confiancaMinima) {}
+
+bool HistereseCor::atualizar(Cor cor, float confianca) {
+    if (!valida_) {
+        valida_ = true;
+        reportada_ = cor;
+        return true;
+    }
+
+    if (cor == reportada_) {
+        contagem_ = 0;
+        return false;
+    }
+
+    // Votacao dividida (ROI na borda entre duas cores) nao conta como evidencia
+    if (confianca < confiancaMinima_) return false;
+
+    if (cor == candidata_ && contagem_ > 0) {
+        contagem_++;
+    } else {
+        candidata_ = cor;
+        contagem_ = 1;
+    }
+
+    if (contagem_ >= confirmacoes_) {
+        reportada_ = cor;
+        contagem_ = 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,47 @@
+// estado.cpp
+#include "estado.h"
+#include <cstring>
+#include <thread>
+
+EstadoCompartilhado::EstadoCompartilhado() {
+    guardar(EstadoSistema());
+}
+
+EstadoSistema EstadoCompartilhado::ler() const {
+    while (true) {
+        uint64_t antes = seq_.load(std::memory_order_acquire);
+        if (antes & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        EstadoSistema estado = carregar();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == antes) return estado;
+    }
+}
+
+uint64_t EstadoCompartilhado::travarEscrita() {
+    uint64_t s = seq_.load(std::memory_order_relaxed);
+    while ((s & 1) || !seq_.compare_exchange_weak(s, s + 1, std::memory_order_acquire)) {
+        if (s & 1) {
+            std::this_thread::yield();
+            s = seq_.load(std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return s + 1;
+}
+
+EstadoSistema EstadoCompartilhado::carregar() const {
+    uint64_t palavras[PALAVRAS];
+    for (size_t i = 0; i < PALAVRAS; i++) palavras[i] = dados_[i].load(std::memory_order_relaxed);
+    EstadoSistema estado;
+    std::memcpy(&estado, palavras, sizeof(estado));
+    return estado;
+}
+
+void EstadoCompartilhado::guardar(const EstadoSistema& estado) {
+    uint64_t palavras[PALAVRAS] = {};
+    std::memcpy(palavras, &estado, sizeof(estado));
+    for (size_t i = 0; i < PALAVRAS; i++) dados_[i].store(palavras[i], std::memory_order_relaxed);
+}
@@ -0,0 +1,222 @@
+// frame_recorder.cpp
+#include "frame_recorder.h"
+#include "camera.h"
+#include "log.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+FrameRecorder::FrameRecorder(size_t buffers) : buffers_(buffers) {}
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::open(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOG_ERRO("Erro ao criar gravacao {}", path);
+        return false;
+    }
+    parar_ = false;
+    temCabecalho_ = false;
+    writer_ = std::thread(&FrameRecorder::writerLoop, this);
+    return true;
+}
+
+void FrameRecorder::close() {
+    if (fd_ < 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        parar_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void FrameRecorder::recordFrame(const Frame& frame) {
+    if (fd_ < 0 || !frame.bruto) return;
+
+    // Compacta as linhas: no arquivo o stride e sempre o minimo do formato
+    size_t linha = rawFrameSize(frame.brutoFormato, frame.brutoTamanho.width, 1);
+    size_t tamanho = linha * frame.brutoTamanho.height;
+
+    std::vector<uint8_t> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!temCabecalho_) {
+            std::memcpy(cabecalho_.magic, MAGIC_GRAVACAO, sizeof(MAGIC_GRAVACAO));
+            cabecalho_.versao = 1;
+            cabecalho_.formato = static_cast<uint32_t>(frame.brutoFormato);
+            cabecalho_.largura = frame.brutoTamanho.width;
+            cabecalho_.altura = frame.brutoTamanho.height;
+            temCabecalho_ = true;
+        } else if (cabecalho_.formato != static_cast<uint32_t>(frame.brutoFormato) ||
+                   cabecalho_.largura != static_cast<uint32_t>(frame.brutoTamanho.width) ||
+                   cabecalho_.altura != static_cast<uint32_t>(frame.brutoTamanho.height)) {
+            dropped_++;  // uma gravacao tem um formato so
+            return;
+        }
+
+        if (!livres_.empty()) {
+            buffer.swap(livres_.back());
+            livres_.pop_back();
+        } else if (emUso_ >= buffers_) {
+            dropped_++;
+            return;
+        }
+        emUso_++;
+    }
+
+    // Copia fora do lock: e o unico custo real na thread de captura
+    buffer.resize(tamanho);
+    for (int y = 0; y < frame.brutoTamanho.height; y++) {
+        std::memcpy(buffer.data() + y * linha, frame.bruto + y * frame.brutoStride, linha);
+    }
+
+    Item item;
+    item.cabecalho = {static_cast<uint32_t>(TipoRegistro::Quadro), static_cast<uint32_t>(tamanho), frame.seq,
+                      frame.timestampNs};
+    item.dados.swap(buffer);
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        fila_.push_back(std::move(item));
+    }
+    cv_.notify_one();
+}
+
+void FrameRecorder::recordDecision(uint64_t seq, int64_t timestampNs, const cv::Rect& roi,
+                                   const cv::Scalar& media, Cor cor, float confianca) {
+    if (fd_ < 0) return;
+
+    RegistroDecisao decisao{};
+    decisao.roi[0] = roi.x;
+    decisao.roi[1] = roi.y;
+    decisao.roi[2] = roi.width;
+    decisao.roi[3] = roi.height;
+    for (int i = 0; i < 3; i++) decisao.media[i] = static_cast<float>(media[i]);
+    decisao.confianca = confianca;
+    decisao.cor = static_cast<uint8_t>(cor);
+
+    Item item;
+    item.cabecalho = {static_cast<uint32_t>(TipoRegistro::Decisao), sizeof(decisao), seq, timestampNs};
+    item.dados.resize(sizeof(decisao));
+    std::memcpy(item.dados.data(), &decisao, sizeof(decisao));
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        fila_.push_back(std::move(item));
+    }
+    cv_.notify_one();
+}
+
+bool FrameRecorder::writeAll(const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd_, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void FrameRecorder::writerLoop() {
+    bool escreveuCabecalho = false;
+    bool erro = false;
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        cv_.wait(lock, [this] { return parar_ || !fila_.empty(); });
+        if (fila_.empty()) break;  // parar_ e nada mais a escrever
+
+        Item item = std::move(fila_.front());
+        fila_.pop_front();
+        CabecalhoGravacao cabecalho = cabecalho_;
+        lock.unlock();
+
+        // Decisoes so chegam depois do quadro delas, entao o cabecalho ja existe
+        if (!erro && !escreveuCabecalho) {
+            erro = !writeAll(&cabecalho, sizeof(cabecalho));
+            escreveuCabecalho = true;
+        }
+        if (!erro) {
+            erro = !writeAll(&item.cabecalho, sizeof(item.cabecalho)) ||
+                   !writeAll(item.dados.data(), item.dados.size());
+            if (erro) LOG_ERRO("Erro de escrita na gravacao, descartando o resto");
+        }
+        bool quadro = item.cabecalho.tipo == static_cast<uint32_t>(TipoRegistro::Quadro);
+        if (quadro && !erro) recorded_++;
+
+        lock.lock();
+        if (quadro) {
+            if (erro) dropped_++;
+            livres_.push_back(std::move(item.dados));
+            emUso_--;
+        }
+    }
+}
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+bool RecordingReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERRO("Erro ao abrir gravacao {}", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(CabecalhoGravacao)) {
+        LOG_ERRO("Gravacao vazia ou sem cabecalho: {}", path);
+        ::close(fd);
+        return false;
+    }
+    length_ = st.st_size;
+    void* map = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    data_ = static_cast<const uint8_t*>(map);
+
+    std::memcpy(&cabecalho_, data_, sizeof(cabecalho_));
+    if (std::memcmp(cabecalho_.magic, MAGIC_GRAVACAO, sizeof(MAGIC_GRAVACAO)) != 0 || cabecalho_.versao != 1) {
+        LOG_ERRO("Arquivo nao e uma gravacao valida: {}", path);
+        close();
+        return false;
+    }
+
+    // Indexa os registros; para no primeiro incompleto
+    size_t tamanhoQuadro = stride() * cabecalho_.altura;
+    size_t pos = sizeof(CabecalhoGravacao);
+    while (pos + sizeof(CabecalhoRegistro) <= length_) {
+        CabecalhoRegistro r;
+        std::memcpy(&r, data_ + pos, sizeof(r));
+        pos += sizeof(r);
+        if (pos + r.tamanho > length_) break;
+
+        if (r.tipo == static_cast<uint32_t>(TipoRegistro::Quadro) && r.tamanho == tamanhoQuadro) {
+            quadros_.push_back({r.seq, r.timestampNs, data_ + pos});
+        } else if (r.tipo == static_cast<uint32_t>(TipoRegistro::Decisao) && r.tamanho == sizeof(RegistroDecisao)) {
+            DecisaoGravada d{r.seq, r.timestampNs, {}};
+            std::memcpy(&d.decisao, data_ + pos, sizeof(d.decisao));
+            decisoes_.push_back(d);
+        }
+        pos += r.tamanho;
+    }
+    return true;
+}
+
+void RecordingReader::close() {
+    if (data_) munmap(const_cast<uint8_t*>(data_), length_);
+    data_ = nullptr;
+    quadros_.clear();
+    decisoes_.clear();
+}
+
+size_t RecordingReader::stride() const {
+    return rawFrameSize(format(), cabecalho_.largura, 1);
+}
@@ -0,0 +1,60 @@
+#include "frame_ring.h"
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+FrameRing::FrameRing() {
+    fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+FrameRing::~FrameRing() {
+    if (fd_ >= 0) close(fd_);
+}
+
+Frame& FrameRing::escrita() {
+    return slots_[escrita_];
+}
+
+void FrameRing::publicar() {
+    unsigned anterior = meio_.exchange(escrita_ | NOVO, std::memory_order_acq_rel);
+    if (anterior & NOVO) descartados_++;  // o consumidor nunca viu o quadro anterior
+    escrita_ = anterior & ~NOVO;
+    publicados_++;
+
+    uint64_t um = 1;
+    (void)!write(fd_, &um, sizeof(um));
+}
+
+Frame* FrameRing::maisRecente() {
+    if (!(meio_.load(std::memory_order_acquire) & NOVO)) return nullptr;
+    unsigned anterior = meio_.exchange(leitura_, std::memory_order_acq_rel);
+    leitura_ = anterior & ~NOVO;
+    return &slots_[leitura_];
+}
+
+Frame* FrameRing::aguardar(int timeoutMs) {
+    // Zera avisos pendentes (fd nao bloqueante), para quem espera no fd
+    // via poll/epoll nao ser acordado de novo por um quadro ja consumido
+    uint64_t contador;
+    (void)!read(fd_, &contador, sizeof(contador));
+
+    Frame* frame = maisRecente();
+    if (frame) return frame;
+
+    // O read acima pode ter engolido o aviso de um acordar(); a flag nao se perde
+    if (acordado_.exchange(false, std::memory_order_acq_rel)) return nullptr;
+
+    pollfd pfd{fd_, POLLIN, 0};
+    if (poll(&pfd, 1, timeoutMs) > 0) {
+        (void)!read(fd_, &contador, sizeof(contador));
+    }
+    // Um acordar() durante o poll fica na flag: a proxima chamada sem quadro
+    // retorna na hora em vez de bloquear
+    return maisRecente();
+}
+
+void FrameRing::acordar() {
+    acordado_.store(true, std::memory_order_release);
+    uint64_t um = 1;
+    (void)!write(fd_, &um, sizeof(um));
+}
@@ -0,0 +1,19 @@
+// hal.cpp
+#include "hal.h"
+#include "hal_simulado.h"
+
+namespace {
+
+std::unique_ptr<Gpio> backend;
+
+}  // namespace
+
+Gpio& gpio() {
+    // Sem backend instalado (bench, testes, build sem wiringPi) os pinos sao simulados
+    if (!backend) backend.reset(new GpioSimulado());
+    return *backend;
+}
+
+void usarGpio(std::unique_ptr<Gpio> novo) {
+    backend = std::move(novo);
+}
@@ -0,0 +1,405 @@
+// hal_simulado.cpp
+#include "hal_simulado.h"
+#include "metricas.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+// Datasheet do HD44780 a 3.3 V
+constexpr int64_t T_LIGAR_NS = 40000000;     // espera apos ligar
+constexpr int64_t T_AS_NS = 40;              // RS estavel antes do E
+constexpr int64_t T_PWEH_NS = 450;           // largura do pulso de E
+constexpr int64_t T_CYCE_NS = 1000;          // ciclo do E
+constexpr int64_t T_DSW_NS = 195;            // dados estaveis antes da descida do E
+constexpr int64_t T_H_NS = 10;               // dados mantidos apos a descida do E
+constexpr int64_t T_EXEC_NS = 37000;
+constexpr int64_t T_CLEAR_NS = 1520000;
+constexpr int64_t T_INIT1_NS = 4100000;
+constexpr int64_t T_INIT2_NS = 100000;
+
+constexpr size_t MAX_VIOLACOES = 16;
+constexpr size_t MAX_MOMENTOS = 100000;
+
+// Repiques de um aperto ou de uma soltura ficam dentro disso: uma descida
+// depois de tanto tempo de linha parada comeca um clique
+constexpr int64_t JANELA_CLIQUE_NS = 50000000;
+
+// Esperas de barramento puladas pela thread; cada thread tem seu relogio simulado
+thread_local int64_t avancoThread = 0;
+
+}  // namespace
+
+LcdVirtual::LcdVirtual(int rs, int e, int d4, int d5, int d6, int d7, int cols, int rows, int64_t ligadoNs)
+    : rs_(rs), e_(e), d_{d4, d5, d6, d7}, cols_(cols), rows_(rows > 4 ? 4 : rows), ligadoNs_(ligadoNs) {
+    memset(ddram_, ' ', sizeof(ddram_));
+}
+
+void LcdVirtual::violacao(const std::string& texto, int64_t t) {
+    totalViolacoes_++;
+    if (violacoes_.size() < MAX_VIOLACOES) {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "t=%.3fms %s", (t - ligadoNs_) / 1e6, texto.c_str());
+        violacoes_.push_back(buf);
+    }
+}
+
+void LcdVirtual::aoMudar(int pino, bool nivel, int64_t t, int64_t tReal, const bool* niveis) {
+    if (pino == e_) {
+        if (nivel && !eAlto_) {
+            if (t - rsMudou_ < T_AS_NS) violacao("tAS < 40 ns", t);
+            if (eSubiu_ >= 0 && t - eSubiu_ < T_CYCE_NS) violacao("tcycE < 1000 ns", t);
+            eSubiu_ = t;
+        } else if (!nivel && eAlto_) {
+            if (t - eSubiu_ < T_PWEH_NS) violacao("PWEH < 450 ns", t);
+            if (t - dadosMudaram_ < T_DSW_NS) violacao("tDSW < 195 ns", t);
+            eDesceu_ = t;
+            uint8_t nibble = 0;
+            for (int bit = 0; bit < 4; bit++) {
+                if (niveis[d_[bit]]) nibble |= 1 << bit;
+            }
+            latch(nibble, niveis[rs_], t);
+            if (niveis[rs_] && !temNibbleAlto_ && momentosDados_.size() < MAX_MOMENTOS) {
+                momentosDados_.push_back(tReal);
+            }
+        }
+        eAlto_ = nivel;
+        return;
+    }
+
+    bool ehDado = false;
+    for (int pin : d_) ehDado = ehDado || pin == pino;
+    if (pino != rs_ && !ehDado) return;
+
+    if (eAlto_) violacao("RS/dados mudaram com E alto", t);
+    else if (eDesceu_ >= 0 && t - eDesceu_ < T_H_NS) violacao("tH < 10 ns", t);
+    if (pino == rs_) rsMudou_ = t;
+    else dadosMudaram_ = t;
+}
+
+void LcdVirtual::latch(uint8_t nibble, bool rs, int64_t t) {
+    if (t - ligadoNs_ < T_LIGAR_NS) violacao("menos de 40 ms apos ligar", t);
+
+    // Entre os dois nibbles de um byte o controlador nao fica ocupado
+    if (!temNibbleAlto_ && t < ocupadoAte_) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "ocupado (faltavam %lld ns)", static_cast<long long>(ocupadoAte_ - t));
+        violacao(buf, t);
+    }
+
+    if (!modo4Bits_) {
+        // Modo 8 bits: so os 4 bits altos chegam, os baixos ficam em 0
+        uint8_t instrucao = static_cast<uint8_t>(nibble << 4);
+        if ((instrucao & 0xF0) == 0x30) {
+            inicializacao_++;
+            ocupadoAte_ = t + (inicializacao_ == 1 ? T_INIT1_NS : inicializacao_ == 2 ? T_INIT2_NS : T_EXEC_NS);
+        } else {
+            if ((instrucao & 0xF0) == 0x20) modo4Bits_ = true;
+            ocupadoAte_ = t + T_EXEC_NS;
+        }
+        comandos_++;
+        return;
+    }
+
+    if (!temNibbleAlto_) {
+        nibbleAlto_ = nibble;
+        inicioByte_ = eSubiu_;
+        temNibbleAlto_ = true;
+        return;
+    }
+    temNibbleAlto_ = false;
+    executar(static_cast<uint8_t>(nibbleAlto_ << 4 | nibble), rs, t);
+    nsBytes_ += ocupadoAte_ - inicioByte_;
+    bytesMedidos_++;
+}
+
+void LcdVirtual::executar(uint8_t byte, bool rs, int64_t t) {
+    int64_t execucao = T_EXEC_NS;
+    if (rs) {
+        ddram_[endereco_] = byte;
+        endereco_ = (endereco_ + 1) & 0x7F;
+        dados_++;
+    } else {
+        comandos_++;
+        if (byte & 0x80) {
+            endereco_ = byte & 0x7F;
+        } else if (byte == 0x01) {
+            memset(ddram_, ' ', sizeof(ddram_));
+            endereco_ = 0;
+            execucao = T_CLEAR_NS;
+        } else if ((byte & 0xFE) == 0x02) {
+            endereco_ = 0;
+            execucao = T_CLEAR_NS;
+        }
+    }
+    ocupadoAte_ = t + execucao;
+}
+
+int LcdVirtual::rowAddress(int row) const {
+    static const int rowAddr16[] = {0x00, 0x40, 0x10, 0x50};
+    static const int rowAddr20[] = {0x00, 0x40, 0x14, 0x54};
+    return cols_ <= 16 ? rowAddr16[row] : rowAddr20[row];
+}
+
+std::string LcdVirtual::linha(int row) const {
+    std::string s;
+    if (row < 0 || row >= rows_) return s;
+    int base = rowAddress(row);
+    for (int c = 0; c < cols_; c++) {
+        uint8_t ch = ddram_[(base + c) & 0x7F];
+        s += (ch >= 0x20 && ch < 0x7F) ? static_cast<char>(ch) : '?';
+    }
+    return s;
+}
+
+GpioSimulado::GpioSimulado(bool esperasReais) : esperasReais_(esperasReais) {
+    for (bool& n : niveis_) n = false;
+}
+
+GpioSimulado::~GpioSimulado() {
+    parar_ = true;
+    for (auto& t : roteiros_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void GpioSimulado::modoSaida(int pino) {
+    if (pino < 0 || pino >= NUM_PINOS) return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    saida_[pino] = true;
+}
+
+void GpioSimulado::modoEntrada(int pino, bool pullUp) {
+    if (pino < 0 || pino >= NUM_PINOS) return;
+    std::lock_guard<std::mutex> lock(mtx_);
+    saida_[pino] = false;
+    if (pullUp) niveis_[pino] = true;
+}
+
+void GpioSimulado::mudar(int pino, bool nivel, int64_t t, int64_t tReal) {
+    if (niveis_[pino] == nivel) return;
+    niveis_[pino] = nivel;
+    linhas_[pino].push_back({barramento_[pino] ? t : tReal, nivel});
+    if (barramento_[pino]) {
+        for (auto& lcd : lcds_) lcd->aoMudar(pino, nivel, t, tReal, niveis_);
+    }
+}
+
+void GpioSimulado::escrever(int pino, bool nivel) {
+    if (pino < 0 || pino >= NUM_PINOS) return;
+    int64_t tReal = agoraNs();
+    int64_t t = tReal + avancoThread;
+    std::lock_guard<std::mutex> lock(mtx_);
+    mudar(pino, nivel, t, tReal);
+}
+
+bool GpioSimulado::ler(int pino) {
+    if (pino < 0 || pino >= NUM_PINOS) return false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    return niveis_[pino];
+}
+
+void GpioSimulado::escreverMascara(uint32_t set, uint32_t clr) {
+    int64_t tReal = agoraNs();
+    int64_t t = tReal + avancoThread;
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (int pino = 0; pino < 32; pino++) {
+        if (set & (1u << pino)) mudar(pino, true, t, tReal);
+        if (clr & (1u << pino)) mudar(pino, false, t, tReal);
+    }
+}
+
+bool GpioSimulado::registrarInterrupcao(int pino, Borda borda, void (*tratador)()) {
+    if (pino < 0 || pino >= NUM_PINOS) return false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    tratadores_[pino] = tratador;
+    bordas_[pino] = borda;
+    return true;
+}
+
+int64_t GpioSimulado::agora() {
+    return agoraNs() + avancoThread;
+}
+
+void GpioSimulado::esperarNs(long ns) {
+    if (!esperasReais_) {
+        avancoThread += ns;
+        return;
+    }
+    int64_t fim = agoraNs() + ns;
+    while (agoraNs() < fim) {
+    }
+}
+
+void GpioSimulado::dormirUs(long us) {
+    if (!esperasReais_) {
+        avancoThread += us * 1000LL;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+LcdVirtual& GpioSimulado::conectarLcd(int rs, int e, int d4, int d5, int d6, int d7, int cols, int rows) {
+    int64_t t = agora();
+    std::lock_guard<std::mutex> lock(mtx_);
+    lcds_.emplace_back(new LcdVirtual(rs, e, d4, d5, d6, d7, cols, rows, t));
+    for (int pino : {rs, e, d4, d5, d6, d7}) {
+        if (pino >= 0 && pino < NUM_PINOS) barramento_[pino] = true;
+    }
+    return *lcds_.back();
+}
+
+std::vector<PassoEntrada> GpioSimulado::cliques(const std::vector<int>& instantesMs, int repiques) {
+    std::vector<PassoEntrada> passos;
+    for (int ms : instantesMs) {
+        int64_t t = ms * 1000000LL;
+        for (int i = 0; i < repiques; i++) {
+            passos.push_back({t + i * 1000000LL, false});
+            passos.push_back({t + i * 1000000LL + 300000, true});
+        }
+        passos.push_back({t + repiques * 1000000LL, false});
+        int64_t soltura = t + 100000000LL;
+        for (int i = 0; i < repiques; i++) {
+            passos.push_back({soltura + i * 1000000LL, true});
+            passos.push_back({soltura + i * 1000000LL + 300000, false});
+        }
+        passos.push_back({soltura + repiques * 1000000LL, true});
+    }
+    std::stable_sort(passos.begin(), passos.end(),
+                     [](const PassoEntrada& a, const PassoEntrada& b) { return a.aposNs < b.aposNs; });
+    return passos;
+}
+
+void GpioSimulado::roteiro(int pino, std::vector<PassoEntrada> passos) {
+    if (pino < 0 || pino >= NUM_PINOS) return;
+    roteiros_.emplace_back([this, pino, passos] {
+        auto inicio = std::chrono::steady_clock::now();
+        int64_t ultimaBorda = -JANELA_CLIQUE_NS;
+        for (const PassoEntrada& p : passos) {
+            // Dorme em fatias para sair rapido no destrutor
+            auto prazo = inicio + std::chrono::nanoseconds(p.aposNs);
+            while (!parar_ && std::chrono::steady_clock::now() < prazo) {
+                auto fatia = std::min<std::chrono::steady_clock::duration>(
+                    prazo - std::chrono::steady_clock::now(), std::chrono::milliseconds(20));
+                std::this_thread::sleep_for(fatia);
+            }
+            if (parar_) return;
+
+            void (*tratador)() = nullptr;
+            {
+                int64_t t = agoraNs();
+                std::lock_guard<std::mutex> lock(mtx_);
+                bool antes = niveis_[pino];
+                if (antes == p.nivel) continue;
+                mudar(pino, p.nivel, t, t);
+                if (!p.nivel && t - ultimaBorda >= JANELA_CLIQUE_NS) cliquesInjetados_.push_back(t);
+                ultimaBorda = t;
+                Borda b = bordas_[pino];
+                bool casa = b == Borda::Ambas || (b == Borda::Descida && !p.nivel) || (b == Borda::Subida && p.nivel);
+                if (casa) tratador = tratadores_[pino];
+            }
+            // Fora do lock: o tratador pode ler o pino
+            if (tratador) tratador();
+        }
+    });
+}
+
+std::vector<Transicao> GpioSimulado::transicoes(int pino) const {
+    if (pino < 0 || pino >= NUM_PINOS) return {};
+    std::lock_guard<std::mutex> lock(mtx_);
+    return linhas_[pino];
+}
+
+std::string GpioSimulado::relatorio(int pinoBotao, int pinoLaser, const std::vector<int>& padraoLaserMs) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+
+    for (size_t i = 0; i < lcds_.size(); i++) {
+        const LcdVirtual& lcd = *lcds_[i];
+        std::string p = "sim_lcd" + (lcds_.size() > 1 ? std::to_string(i) : std::string()) + "_";
+        for (int row = 0; row < 4; row++) {
+            std::string texto = lcd.linha(row);
+            if (!texto.empty()) out << p << "linha" << row << "=\"" << texto << "\"\n";
+        }
+        out << p << "comandos=" << lcd.comandos() << '\n';
+        out << p << "dados=" << lcd.dados() << '\n';
+        out << p << "ns_por_byte=" << lcd.nsPorByte() << '\n';
+        out << p << "violacoes=" << lcd.totalViolacoes() << '\n';
+        for (const std::string& v : lcd.violacoes()) out << p << "violacao=\"" << v << "\"\n";
+    }
+
+    // Clique -> primeiro byte de dado no LCD depois dele, no relogio real: e o
+    // caminho de software; o barramento aparece em ns_por_byte
+    if (pinoBotao >= 0 && pinoBotao < NUM_PINOS) {
+        out << "sim_botao_cliques=" << cliquesInjetados_.size() << '\n';
+        if (!lcds_.empty()) {
+            const std::vector<int64_t>& dados = lcds_[0]->momentosDados();
+            int64_t soma = 0, maximo = 0;
+            size_t n = 0;
+            for (int64_t clique : cliquesInjetados_) {
+                auto it = std::upper_bound(dados.begin(), dados.end(), clique);
+                if (it == dados.end()) continue;
+                int64_t lat = *it - clique;
+                soma += lat;
+                maximo = std::max(maximo, lat);
+                n++;
+            }
+            out << "sim_botao_lcd_respostas=" << n << '\n';
+            out << "sim_botao_lcd_latencia_media_us=" << (n ? soma / 1000.0 / n : 0.0) << '\n';
+            out << "sim_botao_lcd_latencia_max_us=" << maximo / 1000.0 << '\n';
+        }
+    }
+
+    // Intervalos entre trocas do laser contra o padrao; a fase comeca numa
+    // subida e recomeca quando um intervalo foge mais de 50% do esperado. So
+    // conta o intervalo cujo seguinte tambem segue o padrao: o que terminou
+    // num parar() (clique, fim) ou no fim da linha do tempo fica de fora.
+    if (pinoLaser >= 0 && pinoLaser < NUM_PINOS) {
+        std::vector<int> padrao;
+        for (int ms : padraoLaserMs) padrao.push_back(ms > 0 ? ms : 1);
+        if (padrao.empty()) padrao = {500, 500};
+        if (padrao.size() % 2) padrao.push_back(padrao.back());
+
+        const std::vector<Transicao>& linha = linhas_[pinoLaser];
+        std::vector<int64_t> erros(linha.size(), -1);  // -1: fora do padrao
+        size_t ressincronias = 0;
+        int fase = -1;
+        for (size_t i = 0; i + 1 < linha.size(); i++) {
+            if (fase < 0) {
+                if (!linha[i].nivel) continue;
+                fase = 0;
+            }
+            int64_t esperado = padrao[fase] * 1000000LL;
+            int64_t medido = linha[i + 1].tempoNs - linha[i].tempoNs;
+            int64_t erro = medido > esperado ? medido - esperado : esperado - medido;
+            if (erro * 2 > esperado || linha[i].nivel != (fase % 2 == 0)) {
+                ressincronias++;
+                fase = -1;
+                continue;
+            }
+            erros[i] = erro;
+            fase = (fase + 1) % padrao.size();
+        }
+
+        std::vector<int64_t> contados;
+        for (size_t i = 0; i + 1 < erros.size(); i++) {
+            if (erros[i] >= 0 && erros[i + 1] >= 0) contados.push_back(erros[i]);
+        }
+        int64_t soma = 0;
+        for (int64_t e : contados) soma += e;
+        std::sort(contados.begin(), contados.end());
+        size_t n = contados.size();
+        out << "sim_laser_transicoes=" << linha.size() << '\n';
+        out << "sim_laser_intervalos=" << n << '\n';
+        out << "sim_laser_ressincronias=" << ressincronias << '\n';
+        out << "sim_laser_erro_medio_us=" << (n ? soma / 1000.0 / n : 0.0) << '\n';
+        out << "sim_laser_erro_p50_us=" << (n ? contados[n / 2] / 1000.0 : 0.0) << '\n';
+        out << "sim_laser_erro_max_us=" << (n ? contados.back() / 1000.0 : 0.0) << '\n';
+    }
+    return out.str();
+}
@@ -0,0 +1,94 @@
+// hal_wiringpi.cpp
+#include "hal.h"
+#include "metricas.h"
+#include <wiringPi.h>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace {
+
+// Offsets (em palavras de 32 bits) dos registradores de set/clear do banco 0
+constexpr int GPSET0 = 0x1C / 4;
+constexpr int GPCLR0 = 0x28 / 4;
+
+class WiringPiGpio : public Gpio {
+public:
+    ~WiringPiGpio() override {
+        if (gpio_) munmap(const_cast<uint32_t*>(gpio_), 4096);
+    }
+
+    bool iniciar() override {
+        if (wiringPiSetupGpio() < 0) return false;
+
+        // Escrita direta nos registradores; sem o mapeamento cai para digitalWrite()
+        int fd = open("/dev/gpiomem", O_RDWR | O_SYNC | O_CLOEXEC);
+        if (fd >= 0) {
+            void* map = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (map != MAP_FAILED) gpio_ = static_cast<volatile uint32_t*>(map);
+        }
+        return true;
+    }
+
+    void modoSaida(int pino) override {
+        pinMode(pino, OUTPUT);
+    }
+
+    void modoEntrada(int pino, bool pullUp) override {
+        pinMode(pino, INPUT);
+        if (pullUp) pullUpDnControl(pino, PUD_UP);
+    }
+
+    void escrever(int pino, bool nivel) override {
+        digitalWrite(pino, nivel ? HIGH : LOW);
+    }
+
+    bool ler(int pino) override {
+        return digitalRead(pino) != LOW;
+    }
+
+    void escreverMascara(uint32_t set, uint32_t clr) override {
+        if (gpio_) {
+            gpio_[GPSET0] = set;
+            gpio_[GPCLR0] = clr;
+            return;
+        }
+        for (int pino = 0; pino < 32; pino++) {
+            if (set & (1u << pino)) digitalWrite(pino, HIGH);
+            if (clr & (1u << pino)) digitalWrite(pino, LOW);
+        }
+    }
+
+    bool registrarInterrupcao(int pino, Borda borda, void (*tratador)()) override {
+        int modo = borda == Borda::Descida ? INT_EDGE_FALLING
+                 : borda == Borda::Subida  ? INT_EDGE_RISING
+                                           : INT_EDGE_BOTH;
+        return wiringPiISR(pino, modo, tratador) >= 0;
+    }
+
+    int64_t agora() override {
+        return agoraNs();
+    }
+
+    // usleep() nao tem resolucao abaixo de dezenas de us: espera ocupada no relogio monotonico
+    void esperarNs(long ns) override {
+        int64_t fim = agoraNs() + ns;
+        while (agoraNs() < fim) {
+        }
+    }
+
+    void dormirUs(long us) override {
+        usleep(static_cast<useconds_t>(us));
+    }
+
+private:
+    volatile uint32_t* gpio_ = nullptr;
+};
+
+}  // namespace
+
+std::unique_ptr<Gpio> createWiringPiGpio() {
+    return std::unique_ptr<Gpio>(new WiringPiGpio());
+}
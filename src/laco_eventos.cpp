@@ -0,0 +1,150 @@
+// laco_eventos.cpp
+#include "laco_eventos.h"
+#include "metricas.h"
+#include <algorithm>
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+namespace {
+
+timespec paraTimespec(int64_t ns) {
+    timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    return ts;
+}
+
+}  // namespace
+
+LacoEventos::LacoEventos() {
+    epoll_ = epoll_create1(EPOLL_CLOEXEC);
+    eventoPostado_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    observar(eventoPostado_, [this]() { executarPostados(); });
+}
+
+LacoEventos::~LacoEventos() {
+    for (int fd : timers_) close(fd);
+    for (int fd : sinais_) close(fd);
+    if (eventoPostado_ >= 0) close(eventoPostado_);
+    if (epoll_ >= 0) close(epoll_);
+}
+
+void LacoEventos::observar(int fd, Callback callback) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (callbacks_.count(fd)) {
+        epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &ev);
+    } else {
+        epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ev);
+    }
+    callbacks_[fd] = std::move(callback);
+}
+
+void LacoEventos::esquecer(int fd) {
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    callbacks_.erase(fd);
+}
+
+int LacoEventos::criarTimer(Callback callback) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (fd < 0) return -1;
+    timers_.push_back(fd);
+
+    observar(fd, [fd, callback]() {
+        uint64_t expiracoes;
+        if (read(fd, &expiracoes, sizeof(expiracoes)) == sizeof(expiracoes)) callback();
+    });
+    return fd;
+}
+
+void LacoEventos::armarTimer(int id, int64_t atrasoNs, int64_t periodoNs) {
+    itimerspec spec{};
+    spec.it_value = paraTimespec(std::max<int64_t>(atrasoNs, 1));
+    spec.it_interval = paraTimespec(periodoNs);
+    timerfd_settime(id, 0, &spec, nullptr);
+}
+
+void LacoEventos::armarTimerAbsoluto(int id, int64_t instanteNs) {
+    itimerspec spec{};
+    spec.it_value = paraTimespec(std::max<int64_t>(instanteNs, 1));
+    timerfd_settime(id, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void LacoEventos::desarmarTimer(int id) {
+    itimerspec spec{};
+    timerfd_settime(id, 0, &spec, nullptr);
+}
+
+void LacoEventos::destruirTimer(int id) {
+    esquecer(id);
+    timers_.erase(std::remove(timers_.begin(), timers_.end(), id), timers_.end());
+    close(id);
+}
+
+bool LacoEventos::observarSinais(std::initializer_list<int> sinais, Callback callback) {
+    sigset_t mascara;
+    sigemptyset(&mascara);
+    for (int s : sinais) sigaddset(&mascara, s);
+    if (pthread_sigmask(SIG_BLOCK, &mascara, nullptr) != 0) return false;
+
+    int fd = signalfd(-1, &mascara, SFD_CLOEXEC | SFD_NONBLOCK);
+    if (fd < 0) return false;
+    sinais_.push_back(fd);
+
+    observar(fd, [fd, callback]() {
+        signalfd_siginfo info;
+        while (read(fd, &info, sizeof(info)) == sizeof(info)) {
+        }
+        callback();
+    });
+    return true;
+}
+
+void LacoEventos::postar(Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(mtxPostados_);
+        postados_.push_back(std::move(callback));
+    }
+    uint64_t um = 1;
+    (void)!write(eventoPostado_, &um, sizeof(um));
+}
+
+void LacoEventos::executarPostados() {
+    uint64_t contador;
+    (void)!read(eventoPostado_, &contador, sizeof(contador));
+
+    std::vector<Callback> tarefas;
+    {
+        std::lock_guard<std::mutex> lock(mtxPostados_);
+        tarefas.swap(postados_);
+    }
+    for (Callback& tarefa : tarefas) tarefa();
+}
+
+void LacoEventos::executar() {
+    rodando_ = true;
+    epoll_event eventos[16];
+
+    while (rodando_) {
+        int n = epoll_wait(epoll_, eventos, 16, -1);
+        incrementar(Contador::DespertaresLaco);
+        for (int i = 0; i < n && rodando_; i++) {
+            auto it = callbacks_.find(eventos[i].data.fd);
+            if (it == callbacks_.end()) continue;  // removido por um callback anterior
+
+            // Copia: o callback pode destruir o proprio timer
+            Callback callback = it->second;
+            callback();
+        }
+    }
+}
+
+void LacoEventos::parar() {
+    postar([this]() { rodando_ = false; });
+}
@@ -1,23 +1,70 @@
 #include "laser.h"
-#include <wiringPi.h>
-#include <chrono>
-#include <thread>
+#include "hal.h"
+#include "laco_eventos.h"
+#include "metricas.h"
 
 void configurarLaser(int pino) {
-    pinMode(pino, OUTPUT);
-    digitalWrite(pino, LOW);
+    gpio().modoSaida(pino);
+    gpio().escrever(pino, false);
 }
 
 void ligarLaser(int pino) {
-    digitalWrite(pino, HIGH);
+    MedirEstagio medir(Estagio::Laser);
+    gpio().escrever(pino, true);
 }
 
 void desligarLaser(int pino) {
-    digitalWrite(pino, LOW);
+    MedirEstagio medir(Estagio::Laser);
+    gpio().escrever(pino, false);
 }
 
-void alternarLaser(int pino, bool& estado, int intervaloMs) {
-    estado = !estado;
-    digitalWrite(pino, estado ? HIGH : LOW);
-    std::this_thread::sleep_for(std::chrono::milliseconds(intervaloMs));
+PiscaLaser::PiscaLaser(LacoEventos& laco, int pino)
+    : laco_(laco), pino_(pino) {
+    timer_ = laco_.criarTimer([this]() { avancar(); });
+}
+
+PiscaLaser::~PiscaLaser() {
+    parar();
+    laco_.destruirTimer(timer_);
+}
+
+void PiscaLaser::iniciar(const std::vector<int>& padraoMs) {
+    padrao_.clear();
+    for (int ms : padraoMs) padrao_.push_back(ms > 0 ? ms : 1);
+    if (padrao_.empty()) padrao_ = {500, 500};
+    // Tamanho par: fases pares ligam, impares desligam
+    if (padrao_.size() % 2) padrao_.push_back(padrao_.back());
+
+    fase_ = 0;
+    ativo_ = true;
+    ligarLaser(pino_);
+    prazoNs_ = agoraNs() + padrao_[0] * 1000000LL;
+    laco_.armarTimerAbsoluto(timer_, prazoNs_);
+}
+
+void PiscaLaser::parar() {
+    if (!ativo_) return;
+    ativo_ = false;
+    laco_.desarmarTimer(timer_);
+    desligarLaser(pino_);
+}
+
+void PiscaLaser::avancar() {
+    if (!ativo_) return;
+
+    int64_t agora = agoraNs();
+    registrarLatencia(Estagio::AtrasoLaser, agora - prazoNs_);
+
+    fase_ = (fase_ + 1) % padrao_.size();
+    if (fase_ % 2 == 0) {
+        ligarLaser(pino_);
+    } else {
+        desligarLaser(pino_);
+    }
+
+    // Se o laco ficou parado mais de uma fase inteira, recomeca a contagem
+    // a partir de agora em vez de disparar uma rajada de trocas atrasadas
+    prazoNs_ += padrao_[fase_] * 1000000LL;
+    if (prazoNs_ <= agora) prazoNs_ = agora + padrao_[fase_] * 1000000LL;
+    laco_.armarTimerAbsoluto(timer_, prazoNs_);
 }
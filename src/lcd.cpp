@@ -2,8 +2,9 @@
 
 // lcd.cpp
 #include "lcd.h"
-#include <wiringPi.h>
-#include <unistd.h>
+#include "hal.h"
+#include <vector>
+#include <cstdint>
 
 #define RS 0
 #define E  1
@@ -12,61 +13,131 @@
 #define D6 6
 #define D7 7
 
-void pulseEnable() {
-    digitalWrite(E, HIGH);
-    usleep(500);
-    digitalWrite(E, LOW);
-    usleep(500);
+// Geometria e buffers do modo retido: frontBuffer espelha o que esta no
+// display, backBuffer e a proxima tela composta pelo chamador
+static int lcdCols = 16;
+static int lcdRows = 2;
+static std::vector<char> frontBuffer;
+static std::vector<char> backBuffer;
+
+// Posicao atual do cursor do HD44780 (-1 = desconhecida)
+static int cursorRow = -1;
+static int cursorCol = -1;
+
+static int rowAddress(int row) {
+    // 16 colunas: linhas 3/4 comecam em 0x10/0x50; 20 colunas: 0x14/0x54
+    static const int rowAddr16[] = {0x00, 0x40, 0x10, 0x50};
+    static const int rowAddr20[] = {0x00, 0x40, 0x14, 0x54};
+    return lcdCols <= 16 ? rowAddr16[row] : rowAddr20[row];
+}
+
+static std::unique_ptr<LcdTransport> transport;
+
+// Comandos clear (0x01) e home (0x02) levam 1.52 ms; os demais o transporte ja cobre
+constexpr long T_CLEAR_US = 1600;
+
+static void sendBytes(const uint8_t* data, size_t len, int mode) {
+    if (transport) transport->write(data, len, mode != 0);
 }
 
-void sendNibble(int data) {
-    digitalWrite(D4, (data >> 0) & 1);
-    digitalWrite(D5, (data >> 1) & 1);
-    digitalWrite(D6, (data >> 2) & 1);
-    digitalWrite(D7, (data >> 3) & 1);
-    pulseEnable();
+static void sendByte(int data, int mode) {
+    uint8_t b = static_cast<uint8_t>(data);
+    sendBytes(&b, 1, mode);
 }
 
-void sendByte(int data, int mode) {
-    digitalWrite(RS, mode);
-    sendNibble(data >> 4);
-    sendNibble(data & 0x0F);
-    usleep(100);
+void lcdInit(int cols, int rows) {
+    lcdInit(createGpioTransport(RS, E, D4, D5, D6, D7), cols, rows);
 }
 
-void lcdInit() {
-    pinMode(RS, OUTPUT);
-    pinMode(E, OUTPUT);
-    pinMode(D4, OUTPUT);
-    pinMode(D5, OUTPUT);
-    pinMode(D6, OUTPUT);
-    pinMode(D7, OUTPUT);
-
-    usleep(50000);
-    sendNibble(0x03); usleep(4500);
-    sendNibble(0x03); usleep(4500);
-    sendNibble(0x03); usleep(150);
-    sendNibble(0x02);
-
-    sendByte(0x28, 0);
-    sendByte(0x0C, 0);
-    sendByte(0x06, 0);
+void lcdInit(std::unique_ptr<LcdTransport> t, int cols, int rows) {
+    lcdCols = cols;
+    lcdRows = rows > 4 ? 4 : rows;
+    frontBuffer.assign(lcdCols * lcdRows, ' ');
+    backBuffer.assign(lcdCols * lcdRows, ' ');
+
+    transport = std::move(t);
+    if (!transport || !transport->begin()) {
+        transport.reset();
+        return;
+    }
+
+    // Sequencia de inicializacao por instrucao (datasheet, figura 24)
+    gpio().dormirUs(40000);
+    transport->writeNibble(0x03); gpio().dormirUs(4100);
+    transport->writeNibble(0x03); gpio().dormirUs(100);
+    transport->writeNibble(0x03);
+    transport->writeNibble(0x02);
+
+    const uint8_t setup[] = {0x28, 0x0C, 0x06};
+    sendBytes(setup, sizeof(setup), 0);
     sendByte(0x01, 0);
-    usleep(2000);
+    gpio().dormirUs(T_CLEAR_US);
+    cursorRow = 0;
+    cursorCol = 0;
 }
 
 void lcdClear() {
     sendByte(0x01, 0);
-    usleep(2000);
+    gpio().dormirUs(T_CLEAR_US);
+    frontBuffer.assign(lcdCols * lcdRows, ' ');
+    cursorRow = 0;
+    cursorCol = 0;
 }
 
 void lcdSetCursor(int row, int col) {
-    int rowAddr[] = {0x00, 0x40, 0x14, 0x54};
-    sendByte(0x80 + rowAddr[row] + col, 0);
+    sendByte(0x80 + rowAddress(row) + col, 0);
+    cursorRow = row;
+    cursorCol = col;
 }
 
 void lcdPrint(const std::string& text) {
+    sendBytes(reinterpret_cast<const uint8_t*>(text.data()), text.size(), 1);
     for (char c : text) {
-        sendByte(c, 1);
+        if (cursorRow >= 0 && cursorRow < lcdRows && cursorCol >= 0 && cursorCol < lcdCols) {
+            frontBuffer[cursorRow * lcdCols + cursorCol] = c;
+        }
+        if (cursorCol >= 0) cursorCol++;
     }
-}
\ No newline at end of file
+}
+
+void lcdComposeClear() {
+    backBuffer.assign(lcdCols * lcdRows, ' ');
+}
+
+void lcdCompose(int row, const std::string& text, int col) {
+    if (row < 0 || row >= lcdRows || col < 0) return;
+    // Preenche o resto da linha com espacos para apagar texto antigo
+    for (int c = col; c < lcdCols; c++) {
+        size_t i = c - col;
+        backBuffer[row * lcdCols + c] = i < text.size() ? text[i] : ' ';
+    }
+}
+
+void lcdPresent() {
+    std::vector<uint8_t> run;
+    for (int row = 0; row < lcdRows; row++) {
+        int col = 0;
+        while (col < lcdCols) {
+            int i = row * lcdCols + col;
+            if (backBuffer[i] == frontBuffer[i]) {
+                col++;
+                continue;
+            }
+
+            // O HD44780 auto-incrementa o endereco: so reposiciona o cursor ao pular celulas
+            if (cursorRow != row || cursorCol != col) {
+                lcdSetCursor(row, col);
+            }
+
+            // Celulas alteradas consecutivas saem numa unica escrita no transporte
+            run.clear();
+            while (col < lcdCols && backBuffer[row * lcdCols + col] != frontBuffer[row * lcdCols + col]) {
+                frontBuffer[row * lcdCols + col] = backBuffer[row * lcdCols + col];
+                run.push_back(static_cast<uint8_t>(backBuffer[row * lcdCols + col]));
+                col++;
+            }
+            sendBytes(run.data(), run.size(), 1);
+            cursorCol = col;
+        }
+    }
+}
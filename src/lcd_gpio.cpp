@@ -0,0 +1,84 @@
+// lcd_gpio.cpp
+#include "lcd_transport.h"
+#include "hal.h"
+
+namespace {
+
+// Tempos minimos do datasheet do HD44780 (com folga)
+constexpr long T_SETUP_NS = 60;      // tAS: RS/dados estaveis antes do enable
+constexpr long T_ENABLE_NS = 500;    // PWEH: largura do pulso de enable
+constexpr long T_HOLD_NS = 500;      // completa o ciclo minimo de 1 us do enable
+constexpr long T_EXEC_NS = 40000;    // execucao de comandos/dados comuns (37 us)
+
+class GpioTransport : public LcdTransport {
+public:
+    GpioTransport(int rs, int e, int d4, int d5, int d6, int d7)
+        : rs_(rs), e_(e), data_{d4, d5, d6, d7} {}
+
+    bool begin() override {
+        Gpio& g = gpio();
+        g.modoSaida(rs_);
+        g.modoSaida(e_);
+        for (int pin : data_) g.modoSaida(pin);
+        g.escrever(e_, false);
+
+        // RS/D4-D7 num unico acesso aos registradores quando estao no banco 0
+        mask_ = rs_ < 32 && e_ < 32;
+        for (int pin : data_) mask_ = mask_ && pin < 32;
+        return true;
+    }
+
+    void writeNibble(uint8_t nibble) override {
+        sendNibble(nibble, false);
+        gpio().esperarNs(T_EXEC_NS);
+    }
+
+    void write(const uint8_t* data, size_t len, bool rs) override {
+        Gpio& g = gpio();
+        for (size_t i = 0; i < len; i++) {
+            sendNibble(data[i] >> 4, rs);
+            sendNibble(data[i] & 0x0F, rs);
+            g.esperarNs(T_EXEC_NS);
+        }
+    }
+
+private:
+    void sendNibble(uint8_t nibble, bool rs) {
+        Gpio& g = gpio();
+        if (mask_) {
+            uint32_t set = 0, clr = 0;
+            (rs ? set : clr) |= 1u << rs_;
+            for (int bit = 0; bit < 4; bit++) {
+                ((nibble >> bit) & 1 ? set : clr) |= 1u << data_[bit];
+            }
+            g.escreverMascara(set, clr);
+            g.esperarNs(T_SETUP_NS);
+            g.escreverMascara(1u << e_, 0);
+            g.esperarNs(T_ENABLE_NS);
+            g.escreverMascara(0, 1u << e_);
+            g.esperarNs(T_HOLD_NS);
+            return;
+        }
+
+        g.escrever(rs_, rs);
+        for (int bit = 0; bit < 4; bit++) {
+            g.escrever(data_[bit], (nibble >> bit) & 1);
+        }
+        g.esperarNs(T_SETUP_NS);
+        g.escrever(e_, true);
+        g.esperarNs(T_ENABLE_NS);
+        g.escrever(e_, false);
+        g.esperarNs(T_HOLD_NS);
+    }
+
+    int rs_;
+    int e_;
+    int data_[4];
+    bool mask_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<LcdTransport> createGpioTransport(int rs, int e, int d4, int d5, int d6, int d7) {
+    return std::unique_ptr<LcdTransport>(new GpioTransport(rs, e, d4, d5, d6, d7));
+}
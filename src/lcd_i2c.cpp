@@ -0,0 +1,116 @@
+// lcd_i2c.cpp
+#include "lcd_transport.h"
+#include "log.h"
+#include <cstdio>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+
+namespace {
+
+// Pinagem do PCF8574 nos backpacks comuns: P0=RS, P2=E, P3=backlight, P4-P7=D4-D7
+constexpr uint8_t LCD_BACKLIGHT = 0x08;
+constexpr uint8_t ENABLE = 0x04;
+constexpr uint8_t RS_BIT = 0x01;
+
+// Cada caractere custa 4 bytes no barramento (um pulso de enable por nibble,
+// o minimo do modo 4 bits) de 9 bits cada: os 32 caracteres de um 16x2 levam
+// ~11,5 ms a 100 kHz e ~2,9 ms a 400 kHz, fora os comandos de cursor. Abaixo
+// de 5 ms so a 400 kHz.
+constexpr uint32_t FREQUENCIA_MINIMA_HZ = 400000;
+constexpr int BITS_POR_TELA = 32 * 4 * 9;
+
+// Frequencia do adaptador pelo device tree (u32 big-endian), 0 se desconhecida
+uint32_t frequenciaBarramento(const std::string& device) {
+    std::string nome = device.substr(device.find_last_of('/') + 1);  // "i2c-1"
+    std::FILE* f = std::fopen(("/sys/class/i2c-adapter/" + nome + "/of_node/clock-frequency").c_str(), "rb");
+    if (!f) return 0;
+    uint8_t b[4];
+    size_t lidos = std::fread(b, 1, sizeof(b), f);
+    std::fclose(f);
+    if (lidos != sizeof(b)) return 0;
+    return static_cast<uint32_t>(b[0]) << 24 | static_cast<uint32_t>(b[1]) << 16 |
+           static_cast<uint32_t>(b[2]) << 8 | b[3];
+}
+
+class I2cTransport : public LcdTransport {
+public:
+    I2cTransport(const std::string& device, int address)
+        : device_(device), address_(address) {}
+
+    ~I2cTransport() override {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    bool begin() override {
+        fd_ = open(device_.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd_ < 0) {
+            LOG_ERRO("Erro ao abrir o barramento I2C {}", device_);
+            return false;
+        }
+        if (ioctl(fd_, I2C_SLAVE, address_) < 0) {
+            char endereco[8];
+            std::snprintf(endereco, sizeof(endereco), "0x%02x", address_);
+            LOG_ERRO("Erro ao conectar com o LCD no endereco {}", endereco);
+            close(fd_);
+            fd_ = -1;
+            return false;
+        }
+
+        uint32_t hz = frequenciaBarramento(device_);
+        if (hz == 0) {
+            LOG_INFO("[LCD] Frequencia do I2C desconhecida; a tela cheia so fica abaixo de 5 ms a 400 kHz");
+        } else if (hz < FREQUENCIA_MINIMA_HZ) {
+            LOG_AVISO("[LCD] I2C a {} Hz: tela cheia leva ~{} ms; use dtparam=i2c_arm_baudrate=400000", hz,
+                      BITS_POR_TELA * 1000.0 / hz);
+        }
+        return true;
+    }
+
+    void writeNibble(uint8_t nibble) override {
+        uint8_t bits = static_cast<uint8_t>(nibble << 4) | LCD_BACKLIGHT;
+        uint8_t buf[] = {bits, static_cast<uint8_t>(bits | ENABLE), bits};
+        flush(buf, sizeof(buf));
+        usleep(40);
+    }
+
+    // Cada byte do barramento leva ~90 us a 100 kHz (~23 us a 400 kHz), o que ja
+    // cobre a largura do enable e os 37 us de execucao: nada de sleep entre bytes
+    void write(const uint8_t* data, size_t len, bool rs) override {
+        uint8_t mode = (rs ? RS_BIT : 0) | LCD_BACKLIGHT;
+
+        buffer_.clear();
+        buffer_.reserve(1 + len * 4);
+        buffer_.push_back(mode);  // RS estavel antes do primeiro enable (tAS)
+        for (size_t i = 0; i < len; i++) {
+            uint8_t high = mode | (data[i] & 0xF0);
+            uint8_t low = mode | static_cast<uint8_t>((data[i] << 4) & 0xF0);
+            buffer_.push_back(high | ENABLE);
+            buffer_.push_back(high);
+            buffer_.push_back(low | ENABLE);
+            buffer_.push_back(low);
+        }
+        flush(buffer_.data(), buffer_.size());
+    }
+
+private:
+    void flush(const uint8_t* buf, size_t len) {
+        if (fd_ < 0) return;
+        if (::write(fd_, buf, len) != static_cast<ssize_t>(len)) {
+            LOG_LIMITADO(NivelLog::Erro, 1, "Erro de escrita no LCD I2C");
+        }
+    }
+
+    std::string device_;
+    int address_;
+    int fd_ = -1;
+    std::vector<uint8_t> buffer_;
+};
+
+}  // namespace
+
+std::unique_ptr<LcdTransport> createI2cTransport(const std::string& device, int address) {
+    return std::unique_ptr<LcdTransport>(new I2cTransport(device, address));
+}
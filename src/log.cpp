@@ -0,0 +1,280 @@
+// log.cpp
+#include "log.h"
+#include "metricas.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+namespace logdet {
+
+std::atomic<int> nivelMinimo(static_cast<int>(NivelLog::Info));
+
+}  // namespace logdet
+
+namespace {
+
+using logdet::Registro;
+using logdet::TipoArg;
+
+// Fila SPSC de uma thread: produtor e a dona, consumidor e o formatador
+constexpr unsigned TAMANHO_ANEL = 256;
+
+// O formatador acorda sozinho a cada PERIODO_FORMATADOR_MS; o produtor so
+// escreve no eventfd quando o anel dele passa de LIMIAR_ACORDAR registros,
+// para um log esparso nao pagar uma syscall por chamada
+constexpr int PERIODO_FORMATADOR_MS = 50;
+constexpr unsigned LIMIAR_ACORDAR = TAMANHO_ANEL / 2;
+
+struct AnelLog {
+    Registro slots[TAMANHO_ANEL];
+    std::atomic<unsigned> cabeca{0};
+    std::atomic<unsigned> cauda{0};
+    std::atomic<uint64_t> descartados{0};
+    std::atomic<bool> abandonado{false};  // thread dona terminou
+};
+
+std::mutex mtxAneis;  // so no registro de uma thread nova e na varredura
+std::vector<std::shared_ptr<AnelLog>> aneis;
+uint64_t descartadosRemovidos = 0;  // de aneis ja liberados (sob mtxAneis)
+
+std::atomic<bool> formatadorAtivo(false);
+std::atomic<bool> formatadorAcordado(false);
+std::atomic<uint64_t> suprimidos(0);
+// Criado no primeiro iniciarLog() e nunca fechado: um produtor que viu
+// formatadorAtivo antes de um pararLog() ainda pode escrever nele, e o numero
+// nao pode ser reaproveitado por outro arquivo
+int fdAcordar = -1;
+std::atomic<bool> pararFormatador(false);
+std::thread tFormatador;
+std::mutex mtxSaida;
+int64_t inicioNs = agoraNs();
+
+struct DonoAnel {
+    std::shared_ptr<AnelLog> anel;
+
+    DonoAnel() : anel(std::make_shared<AnelLog>()) {
+        std::lock_guard<std::mutex> lock(mtxAneis);
+        aneis.push_back(anel);
+    }
+    ~DonoAnel() { anel->abandonado = true; }
+};
+
+AnelLog& anelDaThread() {
+    thread_local DonoAnel dono;
+    return *dono.anel;
+}
+
+void anexarArgumento(std::string& linha, const Registro& r, int i) {
+    char numero[32];
+    switch (r.tipos[i]) {
+        case TipoArg::Inteiro:
+            std::snprintf(numero, sizeof(numero), "%lld", static_cast<long long>(r.args[i].i));
+            linha += numero;
+            break;
+        case TipoArg::SemSinal:
+            std::snprintf(numero, sizeof(numero), "%llu", static_cast<unsigned long long>(r.args[i].u));
+            linha += numero;
+            break;
+        case TipoArg::Real:
+            std::snprintf(numero, sizeof(numero), "%.6g", r.args[i].d);
+            linha += numero;
+            break;
+        case TipoArg::Booleano:
+            linha += r.args[i].u ? "1" : "0";
+            break;
+        case TipoArg::Texto:
+            linha.append(r.texto + r.args[i].t.inicio, r.args[i].t.tamanho);
+            break;
+    }
+}
+
+void formatar(const Registro& r, std::string& linha) {
+    char prefixo[32];
+    std::snprintf(prefixo, sizeof(prefixo), "%.6f ", (r.timestampNs - inicioNs) / 1e9);
+    linha = prefixo;
+
+    int arg = 0;
+    for (const char* p = r.formato; *p; p++) {
+        if (p[0] == '{' && p[1] == '}') {
+            if (arg < r.nArgs) anexarArgumento(linha, r, arg++);
+            p++;
+        } else {
+            linha += *p;
+        }
+    }
+    linha += '\n';
+}
+
+void escrever(const Registro& r, std::string& linha) {
+    formatar(r, linha);
+    std::FILE* saida = r.nivel >= NivelLog::Aviso ? stderr : stdout;
+    std::fwrite(linha.data(), 1, linha.size(), saida);
+}
+
+// Uma passada por todos os aneis; retorna o total descartado ate agora
+uint64_t esvaziarAneis() {
+    std::vector<std::shared_ptr<AnelLog>> copia;
+    {
+        std::lock_guard<std::mutex> lock(mtxAneis);
+        copia = aneis;
+    }
+
+    std::lock_guard<std::mutex> saida(mtxSaida);
+
+    // Junta os registros de todas as threads e escreve em ordem de tempo;
+    // os slots so sao devolvidos aos produtores depois de escritos
+    std::vector<const Registro*> pendentes;
+    std::vector<unsigned> fins(copia.size());
+    uint64_t descartados = 0;
+    for (size_t i = 0; i < copia.size(); i++) {
+        AnelLog& anel = *copia[i];
+        unsigned c = anel.cauda.load(std::memory_order_relaxed);
+        fins[i] = anel.cabeca.load(std::memory_order_acquire);
+        for (; c != fins[i]; c++) pendentes.push_back(&anel.slots[c % TAMANHO_ANEL]);
+        descartados += anel.descartados.load(std::memory_order_relaxed);
+    }
+    std::stable_sort(pendentes.begin(), pendentes.end(), [](const Registro* a, const Registro* b) {
+        return a->timestampNs < b->timestampNs;
+    });
+
+    std::string linha;
+    for (const Registro* r : pendentes) escrever(*r, linha);
+    for (size_t i = 0; i < copia.size(); i++) copia[i]->cauda.store(fins[i], std::memory_order_release);
+    std::fflush(stdout);
+    std::fflush(stderr);
+
+    // Aneis de threads que ja terminaram e estao vazios saem da lista
+    std::lock_guard<std::mutex> lock(mtxAneis);
+    for (size_t i = 0; i < aneis.size();) {
+        AnelLog& anel = *aneis[i];
+        if (anel.abandonado && anel.cauda == anel.cabeca) {
+            descartadosRemovidos += anel.descartados;
+            aneis.erase(aneis.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    return descartados + descartadosRemovidos;
+}
+
+void lacoFormatador() {
+    uint64_t descartadosAvisados = 0;
+    while (true) {
+        pollfd pfd{fdAcordar, POLLIN, 0};
+        if (poll(&pfd, 1, PERIODO_FORMATADOR_MS) > 0 && (pfd.revents & POLLIN)) {
+            uint64_t contador;
+            (void)!read(fdAcordar, &contador, sizeof(contador));
+        }
+        bool parar = pararFormatador;
+
+        // Zera antes de ler, com RMW: se o exchange(true) de um produtor veio
+        // antes, este le o true dele e ve a cabeca ja avancada; se veio depois,
+        // o produtor le false e acorda de novo (e, no pior caso, o periodo
+        // acorda o formatador de qualquer forma). Um store simples poderia ser
+        // reordenado depois das leituras das cabecas.
+        formatadorAcordado.exchange(false, std::memory_order_acq_rel);
+        uint64_t descartados = esvaziarAneis();
+        definir(Contador::LogsDescartados, descartados);
+        if (descartados != descartadosAvisados) {
+            std::fprintf(stderr, "[LOG] %llu mensagens descartadas (anel cheio)\n",
+                         static_cast<unsigned long long>(descartados - descartadosAvisados));
+            descartadosAvisados = descartados;
+        }
+        if (parar) break;
+    }
+}
+
+void acordarFormatador() {
+    if (formatadorAcordado.load(std::memory_order_relaxed)) return;  // ja vai acordar
+    if (!formatadorAcordado.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t um = 1;
+        (void)!write(fdAcordar, &um, sizeof(um));
+    }
+}
+
+}  // namespace
+
+namespace logdet {
+
+Registro* reservar() {
+    AnelLog& anel = anelDaThread();
+    unsigned h = anel.cabeca.load(std::memory_order_relaxed);
+    if (h - anel.cauda.load(std::memory_order_acquire) >= TAMANHO_ANEL) {
+        anel.descartados.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Registro* r = &anel.slots[h % TAMANHO_ANEL];
+    r->timestampNs = agoraNs();
+    return r;
+}
+
+void confirmar() {
+    AnelLog& anel = anelDaThread();
+    unsigned h = anel.cabeca.fetch_add(1, std::memory_order_release) + 1;
+
+    if (formatadorAtivo.load(std::memory_order_acquire)) {
+        // Abaixo do limiar o registro espera a proxima volta do formatador
+        if (h - anel.cauda.load(std::memory_order_relaxed) >= LIMIAR_ACORDAR) acordarFormatador();
+    } else {
+        esvaziarAneis();  // sem thread de fundo: sincrono
+    }
+}
+
+bool Limite::permitir() {
+    int64_t segundo = agoraNs() / 1000000000LL;
+    int64_t janela = janela_.load(std::memory_order_relaxed);
+    if (janela != segundo && janela_.compare_exchange_strong(janela, segundo, std::memory_order_relaxed)) {
+        usados_.store(0, std::memory_order_relaxed);
+    }
+    if (usados_.fetch_add(1, std::memory_order_relaxed) < porSegundo_) return true;
+    suprimidos.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+}  // namespace logdet
+
+void definirNivelLog(NivelLog nivel) {
+    logdet::nivelMinimo = static_cast<int>(nivel);
+}
+
+bool iniciarLog() {
+    if (formatadorAtivo) return true;
+    if (fdAcordar < 0) fdAcordar = eventfd(0, EFD_CLOEXEC);
+    if (fdAcordar < 0) return false;
+    pararFormatador = false;
+    tFormatador = std::thread(lacoFormatador);
+    formatadorAtivo = true;
+    return true;
+}
+
+void pararLog() {
+    if (!formatadorAtivo) return;
+    formatadorAtivo = false;
+    pararFormatador = true;
+    uint64_t um = 1;
+    (void)!write(fdAcordar, &um, sizeof(um));
+    tFormatador.join();
+    esvaziarAneis();  // o que chegou durante o encerramento
+}
+
+uint64_t logsDescartados() {
+    std::vector<std::shared_ptr<AnelLog>> copia;
+    uint64_t total;
+    {
+        std::lock_guard<std::mutex> lock(mtxAneis);
+        copia = aneis;
+        total = descartadosRemovidos;
+    }
+    for (const std::shared_ptr<AnelLog>& anel : copia) total += anel->descartados;
+    return total;
+}
+
+uint64_t logsSuprimidos() {
+    return suprimidos;
+}
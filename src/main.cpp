@@ -1,208 +1,647 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <csignal>
 #include <iostream>
-#include <mutex>
+#include <memory>
 #include <string>
+#include <vector>
 
-#include <wiringPi.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 #include <opencv2/opencv.hpp>
 
 #include "botao.h"
 #include "camera.h"
+#include "classificador.h"
+#include "detector_mudanca.h"
+#include "estado.h"
+#include "frame_recorder.h"
+#include "frame_ring.h"
+#include "hal.h"
+#include "hal_simulado.h"
+#include "laco_eventos.h"
 #include "laser.h"
 #include "lcd.h"
+#include "log.h"
+#include "preview.h"
+#include "metricas.h"
+#include "segmentacao.h"
 
 // Variáveis globais
-std::atomic<bool> sistemaAtivo(false);
 std::atomic<bool> exitProgram(false);
-std::atomic<bool> botaoPressionado(false);
 
-std::mutex mtxCor;
-std::string corDetectada = "";
+// Cor, RGB, confianca, numero de objetos e modo: a camera e o laco publicam,
+// o LCD le um retrato consistente sem nunca travar quem publica
+EstadoCompartilhado estado;
 
 constexpr int PIN_BOTAO = 26;
 constexpr int PIN_LASER = 19;
 
-void threadBotao() {
-    bool ultimoEstadoBotao = true;
-    std::cout << "[BOTAO] Thread iniciada" << std::endl;
-    while (!exitProgram) {
-        if (verificarPressionado(PIN_BOTAO, ultimoEstadoBotao)) {
-            sistemaAtivo = !sistemaAtivo;
-            botaoPressionado = true;
-            std::cout << "[BOTAO] Botao pressionado, sistemaAtivo = " << sistemaAtivo << std::endl;
+// Pipeline da camera: captura -> analise -> preview (opcional), cada um na sua thread
+ConfigPreview configPreview;
+std::atomic<bool> previewQuerQuadros(false);  // janela aberta ou cliente MJPEG conectado
+FrameRing ringCaptura;
+FrameRing ringPreview;
+CameraConfig configCamera;
+RegrasCor regrasCor = RegrasCor::RGB;
+std::string arquivoMetricas = "/tmp/projeto-metricas.txt";
+ModoDeteccao modoDeteccao = ModoDeteccao::Centro;
+CriterioObjeto criterioObjeto = CriterioObjeto::Maior;
+
+// Porteiro de mudanca (detector_mudanca.h): sobre a ROI de 20x20 do modo
+// centro ele custa quase o mesmo que a votacao que evitaria, entao no
+// automatico so liga no modo objetos, onde a segmentacao do quadro e cara
+enum class UsoPorteiro { Auto, Sempre, Nunca };
+UsoPorteiro usoPorteiro = UsoPorteiro::Auto;
+std::vector<int> padraoLaser = {500, 500};
+
+// Gravacao opcional dos quadros crus (e das decisoes) para reproduzir depois
+std::string arquivoGravacao;
+bool gravarDecisoes = false;
+FrameRecorder gravador;
+uint64_t seqCaptura = 0;  // continua entre ativacoes, para a gravacao nao repetir seq
+
+// LCD pelo GPIO paralelo (padrao) ou por um backpack I2C
+bool lcdI2c = false;
+std::string lcdI2cDispositivo = "/dev/i2c-1";
+int lcdI2cEndereco = 0x27;
+
+// --simular: GPIO sem hardware, LCD virtual e cliques de botao roteirizados (ms)
+bool simular = false;
+std::vector<int> cliquesSimulados = {500, 3000};
+GpioSimulado* gpioSimulado = nullptr;  // pertence ao HAL depois de usarGpio()
+
+// Botao, LCD, laser e metricas rodam todos na thread principal, dentro do laco;
+// so captura, analise e preview (trabalho de CPU/GUI) tem thread propria
+LacoEventos laco;
+uint64_t versaoDesenhada = 0;  // so a thread do laco mexe
+std::thread tCamera;
+std::atomic<bool> cameraAtiva(false);
+bool religarCamera = false;  // ativado de novo enquanto a anterior encerrava; so o laco mexe
+std::unique_ptr<PiscaLaser> pisca;
+
+// Estagio de captura: so le quadros da camera, no ritmo que ela entregar,
+// para o buffer interno do driver nunca acumular quadros velhos
+void threadCaptura(FrameSource& fonte, std::atomic<bool>& capturando) {
+    bool gravando = !arquivoGravacao.empty();
+    while (capturando) {
+        Frame& frame = ringCaptura.escrita();
+        if (!fonte.grab(frame)) {
+            if (!capturando) break;  // grab() interrompido pelo fim da camera
+            LOG_LIMITADO(NivelLog::Aviso, 1, "[CAPTURA] Frame vazio!");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        // Do timestamp do quadro ate ele estar pronto; a espera pelo proximo
+        // quadro dentro do grab() fica de fora
+        registrarLatencia(Estagio::Captura, agoraNs() - frame.timestampNs);
+        frame.seq = ++seqCaptura;
+        if (gravando) {
+            gravador.recordFrame(frame);  // antes do proximo grab(), que libera o buffer cru
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ringCaptura.publicar();
+        incrementar(Contador::QuadrosCapturados);
+    }
+}
+
+void definirSistemaAtivo(bool ativo);
+void atualizarLCD(uint64_t versao);
+
+// Versao publicada ainda nao desenhada (0 = nada pendente) e o eventfd que
+// acorda o laco. Sem mutex nem alocacao na thread de analise: varias
+// publicacoes seguidas viram um so write() e o laco desenha a mais nova.
+std::atomic<uint64_t> versaoLCDPendente(0);
+int fdLCD = -1;
+
+void notificarLCD(uint64_t versao) {
+    if (versaoLCDPendente.exchange(versao, std::memory_order_acq_rel) == 0) {
+        uint64_t um = 1;
+        (void)!write(fdLCD, &um, sizeof(um));
     }
-    std::cout << "[BOTAO] Thread finalizada" << std::endl;
 }
+
+// Estagio de analise: sempre pega o quadro mais novo do anel de captura.
+// Existe so enquanto o sistema esta ativo (pararCamera() acorda, cameraTerminou() junta).
 void threadCamera() {
-    cv::VideoCapture cap;
-    int r, g, b;
-    std::cout << "[CAMERA] Thread iniciada" << std::endl;
+    std::unique_ptr<FrameSource> fonte = openCamera(configCamera);
+    if (!fonte) {
+        LOG_ERRO("[CAMERA] Erro ao abrir camera!");
+        laco.postar([]() { definirSistemaAtivo(false); });
+        return;
+    }
+    std::atomic<bool> capturando(true);
+    std::thread tCaptura(threadCaptura, std::ref(*fonte), std::ref(capturando));
+    LOG_INFO("[CAMERA] Camera aberta com sucesso ({})", fonte->name());
+
+    ClassificadorCor classificador(regrasCor);
+    SegmentadorCor segmentador(classificador);
+    DetectorMudanca detector;
+    bool comPorteiro = usoPorteiro == UsoPorteiro::Auto ? modoDeteccao == ModoDeteccao::Objetos
+                                                        : usoPorteiro == UsoPorteiro::Sempre;
+    HistereseCor histerese;
+    std::vector<Objeto> objetosPreview;
+    int objetosPublicados = -1;
+    const int64_t intervaloPreviewNs = static_cast<int64_t>(1e9 / configPreview.fps);
+    int64_t ultimoPreviewNs = 0;
+
+    while (cameraAtiva) {
+        Frame* frame = ringCaptura.aguardar(-1);
+        if (!frame) continue;
+        incrementar(Contador::QuadrosAnalisados);
+        definir(Contador::QuadrosDescartados, ringCaptura.descartados());
+
+        // Cena parada: nada de classificar, publicar no LCD ou logar
+        bool classificar = true;
+        if (comPorteiro) {
+            const cv::Mat& assinatura = modoDeteccao == ModoDeteccao::Objetos ? frame->imagem : frame->roiBGR;
+            classificar = detector.precisaClassificar(assinatura);
+            definir(Contador::QuadrosPulados, detector.pulados());
+        }
+        if (classificar) {
+            int64_t inicio = agoraNs();
+            Cor cor;
+            float confianca;
+            int quantidade = 0;
+
+            if (modoDeteccao == ModoDeteccao::Objetos && !frame->imagem.empty()) {
+                // Quadro inteiro segmentado; o LCD mostra o objeto escolhido pelo criterio
+                const std::vector<Objeto>& objetos = segmentador.segmentar(frame->imagem);
+                const Objeto* alvo = escolherObjeto(objetos, frame->imagem.size(), criterioObjeto);
+                // Cores misturadas na caixa do objeto contam como votacao dividida;
+                // sem objeto nenhum, Indefinido e certo
+                cor = alvo ? alvo->cor : Cor::Indefinido;
+                confianca = alvo ? purezaObjeto(segmentador.classes(), *alvo) : 1.0f;
+                objetosPreview = objetos;
+                quantidade = static_cast<int>(objetos.size());
+            } else {
+                // Cada pixel da ROI vota pela tabela; a cor e a majoritaria
+                ResultadoCor resultado = classificador.votar(frame->roiBGR);
+                cor = resultado.cor;
+                confianca = resultado.confianca;
+            }
 
-    while (!exitProgram) {
-        if (sistemaAtivo) {
-            if (!cap.isOpened()) {
-                cap.open(0);
-                if (!cap.isOpened()) {
-                    std::cerr << "[CAMERA] Erro ao abrir camera!" << std::endl;
-                    sistemaAtivo = false;
-                    continue;
-                } else {
-                    std::cout << "[CAMERA] Camera aberta com sucesso" << std::endl;
-                }
+            int64_t fim = agoraNs();
+            detector.registrarCusto(fim - inicio);
+            registrarLatencia(Estagio::Classificacao, fim - inicio);
+            registrarLatencia(Estagio::Decisao, fim - frame->timestampNs);
+            if (gravarDecisoes) {
+                // Saida crua do classificador, antes da histerese
+                gravador.recordDecision(frame->seq, frame->timestampNs, frame->roi, frame->roiMedia, cor, confianca);
             }
 
-            cv::Mat frame;
-            cap >> frame;
-            if (frame.empty()) {
-                std::cerr << "[CAMERA] Frame vazio!" << std::endl;
-                continue;
+            // So aceita a cena como referencia quando nao ha troca de cor pendente,
+            // senao a confirmacao da histerese nunca chegaria
+            bool trocou = histerese.atualizar(cor, confianca);
+            if (histerese.estavel()) {
+                detector.aceitar();
             }
 
-            int rectSize = 20;
-            int x = frame.cols / 2;
-            int y = frame.rows / 2;
-            cv::Rect roi(x - rectSize / 2, y - rectSize / 2, rectSize, rectSize);
+            if (trocou || quantidade != objetosPublicados) {
+                int64_t inicioPublicacao = agoraNs();
+                Cor corAtual = histerese.cor();
+                uint64_t versao = estado.atualizar([&](EstadoSistema& e) {
+                    if (trocou) {
+                        e.cor = corAtual;
+                        e.corRecebida = true;
+                        e.confianca = confianca;
+                        e.b = cv::saturate_cast<uint8_t>(frame->roiMedia[0]);
+                        e.g = cv::saturate_cast<uint8_t>(frame->roiMedia[1]);
+                        e.r = cv::saturate_cast<uint8_t>(frame->roiMedia[2]);
+                    }
+                    e.objetos = quantidade;
+                });
+                objetosPublicados = quantidade;
+                notificarLCD(versao);
+                registrarLatencia(Estagio::Publicacao, agoraNs() - inicioPublicacao);
+                if (trocou) {
+                    LOG_INFO("[CAMERA] Cor detectada atualizada: {}", nomeCor(corAtual));
+                }
+            }
+        }
+
+        // So copia para o preview no ritmo dele e se alguem estiver olhando
+        if (previewQuerQuadros && !frame->imagem.empty() &&
+            frame->timestampNs - ultimoPreviewNs >= intervaloPreviewNs) {
+            ultimoPreviewNs = frame->timestampNs;
+            Frame& saida = ringPreview.escrita();
+            frame->imagem.copyTo(saida.imagem);
+            saida.seq = frame->seq;
+            saida.timestampNs = frame->timestampNs;
+            saida.roi = frame->roi;
+            saida.cor = histerese.cor();
+            saida.objetos = objetosPreview;
+            ringPreview.publicar();
+        }
+    }
 
-            cv::Mat region = frame(roi);
-            cv::Scalar meanColor = cv::mean(region);
+    capturando = false;
+    fonte->interromper();
+    tCaptura.join();
+    fonte.reset();
+    LOG_INFO("[CAMERA] Camera fechada");
+    LOG_INFO("[CAMERA] Quadros capturados: {}, descartados sem analise: {}", ringCaptura.publicados(),
+             ringCaptura.descartados());
+    if (comPorteiro) {
+        LOG_INFO("[CAMERA] Quadros sem mudanca (nao classificados): {} de {}, CPU economizada ~{} ms "
+                 "(liquida, ja descontados {} ms do detector)",
+                 detector.pulados(), detector.avaliados(), detector.economiaMs(), detector.custoPorteiroMs());
+    }
+}
 
-            b = static_cast<int>(meanColor[0]);
-            g = static_cast<int>(meanColor[1]);
-            r = static_cast<int>(meanColor[2]);
+void iniciarCamera();
 
-            std::string cor = detectColorRGB(cv::Vec3b(b, g, r));
+// Postado no laco pela thread da camera quando ela termina: o join ja nao espera
+void cameraTerminou() {
+    if (tCamera.joinable()) tCamera.join();
+    if (religarCamera) {
+        religarCamera = false;
+        if (estado.ler().ativo) iniciarCamera();
+    }
+}
 
-            {
-                std::lock_guard<std::mutex> lock(mtxCor);
-                if (cor != corDetectada) {
-                    corDetectada = cor;
-                    botaoPressionado = true;
-                    std::cout << "[CAMERA] Cor detectada atualizada: " << cor << std::endl;
-                }
-            }
+void iniciarCamera() {
+    if (tCamera.joinable()) {
+        // A anterior ainda esta encerrando: liga de novo quando ela terminar
+        if (!cameraAtiva) religarCamera = true;
+        return;
+    }
+    cameraAtiva = true;
+    tCamera = std::thread([]() {
+        threadCamera();
+        laco.postar(cameraTerminou);
+    });
+}
 
-            // Desenhar retngulo na regio central e texto com cor detectada
-            cv::rectangle(frame, roi, cv::Scalar(255, 0, 0), 2);
-            cv::putText(frame, cor, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0,
-                        cv::Scalar(255, 255, 255), 2);
+// So sinaliza e volta: juntar aqui prenderia o laco (botao, LCD, laser e
+// sinais) pelo timeout do poll do V4L2 ou por uma espera do replay
+void pararCamera() {
+    religarCamera = false;
+    if (!tCamera.joinable() || !cameraAtiva) return;
+    cameraAtiva = false;
+    ringCaptura.acordar();
+}
 
-            // Redimensionar para 320x240 antes de mostrar
-            cv::Mat resizedFrame;
-            cv::Size tamanho(320, 240);
-            cv::resize(frame, resizedFrame, tamanho);
+// Encerramento, com o laco ja parado: espera a thread de verdade
+void encerrarCamera() {
+    religarCamera = false;
+    cameraAtiva = false;
+    ringCaptura.acordar();
+    if (tCamera.joinable()) tCamera.join();
+}
 
-            cv::imshow("Camera", resizedFrame);
-            cv::waitKey(1);  // para atualizar a imagem na janela
-        } else {
-            if (cap.isOpened()) {
-                cap.release();
+// Estagio de exibicao (opcional): anota o ultimo quadro e mostra numa janela
+// ou manda por MJPEG. Nada aqui roda no modo sem preview.
+void threadPreview() {
+    ServidorMjpeg servidor;
+    if (configPreview.modo == ModoPreview::Mjpeg && !servidor.abrir(configPreview.porta)) {
+        return;
+    }
+    previewQuerQuadros = configPreview.modo == ModoPreview::Janela;
+
+    bool janelaAberta = false;
+    cv::Mat anotado;
+    while (!exitProgram) {
+        pollfd fds[2] = {{ringPreview.fd(), POLLIN, 0}, {servidor.fd(), POLLIN, 0}};
+        poll(fds, servidor.fd() >= 0 ? 2 : 1, -1);
+        if (servidor.fd() >= 0 && (fds[1].revents & POLLIN)) {
+            servidor.aceitar();
+            previewQuerQuadros = servidor.temClientes();
+        }
+
+        Frame* frame = ringPreview.aguardar(0);
+        if (!frame) {
+            if (janelaAberta && !estado.ler().ativo) {
                 cv::destroyWindow("Camera");
-                std::cout << "[CAMERA] Camera fechada" << std::endl;
+                janelaAberta = false;
             }
+            continue;
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        MedirEstagio medir(Estagio::Preview);
+        anotarQuadro(*frame, configPreview.tamanho, anotado);
+        if (configPreview.modo == ModoPreview::Janela) {
+            cv::imshow("Camera", anotado);
+            cv::waitKey(1);  // para atualizar a imagem na janela
+            janelaAberta = true;
+        } else {
+            servidor.enviar(anotado, configPreview.qualidade);
+            previewQuerQuadros = servidor.temClientes();
+        }
     }
 
-    if (cap.isOpened()) {
-        cap.release();
+    if (janelaAberta) {
         cv::destroyWindow("Camera");
     }
-    std::cout << "[CAMERA] Thread finalizada" << std::endl;
 }
 
-
-void threadLaser() {
-    constexpr int intervaloPiscarMs = 500;
-    bool estadoLaser = false;  // varivel para manter o estado do laser
-
-    while (!exitProgram) {
-        if (sistemaAtivo) {
-            alternarLaser(PIN_LASER, estadoLaser, intervaloPiscarMs);
+// Redesenho do LCD, chamado pelo laco quando uma versao nova do estado sai
+void atualizarLCD(uint64_t versao) {
+    if (versao <= versaoDesenhada) return;
+    // Le o retrato mais novo (pode ja ser posterior a versao avisada)
+    EstadoSistema atual = estado.ler();
+    if (atual.versao <= versaoDesenhada) return;
+    versaoDesenhada = atual.versao;
+
+    // Compoe a tela inteira e envia so as celulas alteradas (sem lcdClear)
+    if (atual.ativo) {
+        if (atual.modo == ModoDeteccao::Objetos) {
+            lcdCompose(0, "Ativo " + std::to_string(atual.objetos) + " obj");
         } else {
-            desligarLaser(PIN_LASER);
-            estadoLaser = false;  // garante que o estado est resetado quando inativo
+            lcdCompose(0, "Sistema ativo");
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (atual.corRecebida) {
+            lcdCompose(1, std::string("Cor:") + nomeCor(atual.cor));
+        } else {
+            lcdCompose(1, "Aguardando cor");
+        }
+    } else {
+        lcdCompose(0, "Sistema inativo");
+        lcdCompose(1, "Pressione botao");
+    }
+    {
+        MedirEstagio medir(Estagio::LCD);
+        lcdPresent();
     }
-    desligarLaser(PIN_LASER);
+    LOG_DEBUG("[LCD] Display atualizado (versao {})", atual.versao);
 }
 
+// Opcoes pela linha de comando:
+//   --dispositivo N  --resolucao LxA  --formato yuyv|grey|bgr  --buffers N  --fake arquivo.raw
+//   --regras rgb|hsv  --modo centro|objetos  --lcd-objeto maior|proximo  --porteiro auto|sim|nao
+//   --metricas arquivo ("" desliga)  --log debug|info|aviso|erro
+//   --preview nenhum|janela|mjpeg  --preview-porta N  --preview-fps F
+//   --gravar arquivo.rec [--gravar-decisoes]  --replay arquivo.rec [--replay-rapido]  --laser-padrao ms,ms,... (ligado,desligado,...)
+//   --simular [--simular-cliques ms,ms,...]  --lcd gpio|i2c[:dispositivo[:endereco]]
+std::vector<int> lerListaInteiros(const std::string& valor) {
+    std::vector<int> lista;
+    size_t inicio = 0;
+    while (inicio <= valor.size()) {
+        size_t virgula = valor.find(',', inicio);
+        if (virgula == std::string::npos) virgula = valor.size();
+        lista.push_back(std::stoi(valor.substr(inicio, virgula - inicio)));
+        inicio = virgula + 1;
+    }
+    return lista;
+}
 
-void threadLCD() {
-    std::cout << "[LCD] Thread iniciada" << std::endl;
-    while (!exitProgram) {
-        if (botaoPressionado) {
-            lcdClear();
-            if (sistemaAtivo) {
-                lcdSetCursor(0, 0);
-                lcdPrint("Sistema ativo");
-                lcdSetCursor(1, 0);
-                std::lock_guard<std::mutex> lock(mtxCor);
-                if (!corDetectada.empty()) {
-                    lcdPrint("Cor:");
-                    lcdSetCursor(1, 4);
-                    lcdPrint(corDetectada);
+bool lerOpcoes(int argc, char** argv) {
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string opcao = argv[i];
+            if (opcao == "--gravar-decisoes") {
+                gravarDecisoes = true;
+                continue;
+            }
+            if (opcao == "--replay-rapido") {
+                configCamera.replayRealtime = false;
+                continue;
+            }
+            if (opcao == "--simular") {
+                simular = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "[MAIN] Opcao sem valor: " << opcao << std::endl;
+                return false;
+            }
+            std::string valor = argv[++i];
+
+            if (opcao == "--dispositivo") {
+                configCamera.device = std::stoi(valor);
+            } else if (opcao == "--resolucao") {
+                size_t x = valor.find('x');
+                if (x == std::string::npos) return false;
+                configCamera.width = std::stoi(valor.substr(0, x));
+                configCamera.height = std::stoi(valor.substr(x + 1));
+            } else if (opcao == "--formato") {
+                if (valor == "yuyv") configCamera.format = PixelFormat::YUYV;
+                else if (valor == "grey") configCamera.format = PixelFormat::GREY;
+                else if (valor == "bgr") configCamera.format = PixelFormat::BGR;
+                else return false;
+            } else if (opcao == "--buffers") {
+                configCamera.buffers = std::stoi(valor);
+            } else if (opcao == "--fake") {
+                configCamera.fakeFile = valor;
+            } else if (opcao == "--gravar") {
+                arquivoGravacao = valor;
+            } else if (opcao == "--replay") {
+                configCamera.replayFile = valor;
+            } else if (opcao == "--metricas") {
+                arquivoMetricas = valor;
+            } else if (opcao == "--preview") {
+                if (valor == "nenhum") configPreview.modo = ModoPreview::Nenhum;
+                else if (valor == "janela") configPreview.modo = ModoPreview::Janela;
+                else if (valor == "mjpeg") configPreview.modo = ModoPreview::Mjpeg;
+                else return false;
+            } else if (opcao == "--preview-porta") {
+                configPreview.porta = std::stoi(valor);
+            } else if (opcao == "--preview-fps") {
+                configPreview.fps = std::stod(valor);
+                if (configPreview.fps <= 0) return false;
+            } else if (opcao == "--log") {
+                if (valor == "debug") definirNivelLog(NivelLog::Debug);
+                else if (valor == "info") definirNivelLog(NivelLog::Info);
+                else if (valor == "aviso") definirNivelLog(NivelLog::Aviso);
+                else if (valor == "erro") definirNivelLog(NivelLog::Erro);
+                else return false;
+            } else if (opcao == "--laser-padrao") {
+                padraoLaser = lerListaInteiros(valor);
+            } else if (opcao == "--simular-cliques") {
+                cliquesSimulados = lerListaInteiros(valor);
+                simular = true;
+            } else if (opcao == "--lcd") {
+                // i2c, i2c:/dev/i2c-1 ou i2c:/dev/i2c-1:0x3f
+                if (valor == "gpio") {
+                    lcdI2c = false;
+                } else if (valor.compare(0, 3, "i2c") == 0 && (valor.size() == 3 || valor[3] == ':')) {
+                    lcdI2c = true;
+                    if (valor.size() > 4) {
+                        std::string resto = valor.substr(4);
+                        size_t separador = resto.find(':');
+                        lcdI2cDispositivo = resto.substr(0, separador);
+                        if (separador != std::string::npos) {
+                            lcdI2cEndereco = std::stoi(resto.substr(separador + 1), nullptr, 0);
+                        }
+                    }
                 } else {
-                    lcdPrint("Aguardando cor");
+                    return false;
                 }
+            } else if (opcao == "--regras") {
+                if (valor == "rgb") regrasCor = RegrasCor::RGB;
+                else if (valor == "hsv") regrasCor = RegrasCor::HSV;
+                else return false;
+            } else if (opcao == "--modo") {
+                if (valor == "centro") modoDeteccao = ModoDeteccao::Centro;
+                else if (valor == "objetos") modoDeteccao = ModoDeteccao::Objetos;
+                else return false;
+            } else if (opcao == "--lcd-objeto") {
+                if (valor == "maior") criterioObjeto = CriterioObjeto::Maior;
+                else if (valor == "proximo") criterioObjeto = CriterioObjeto::MaisProximo;
+                else return false;
+            } else if (opcao == "--porteiro") {
+                if (valor == "auto") usoPorteiro = UsoPorteiro::Auto;
+                else if (valor == "sim") usoPorteiro = UsoPorteiro::Sempre;
+                else if (valor == "nao") usoPorteiro = UsoPorteiro::Nunca;
+                else return false;
             } else {
-                lcdSetCursor(0, 0);
-                lcdPrint("Sistema inativo");
-                lcdSetCursor(1, 0);
-                lcdPrint("Pressione botao");
+                std::cerr << "[MAIN] Opcao desconhecida: " << opcao << std::endl;
+                return false;
             }
-            botaoPressionado = false;
-            std::cout << "[LCD] Display atualizado" << std::endl;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    } catch (const std::exception&) {
+        return false;
     }
-    std::cout << "[LCD] Thread finalizada" << std::endl;
+    return true;
 }
 
-int main() {
-    std::cout << "[MAIN] Inicializando wiringPi" << std::endl;
-    wiringPiSetupGpio();
-
-    std::cout << "[MAIN] Configurando botao e laser" << std::endl;
-    configurarBotao(PIN_BOTAO);
-    configurarLaser(PIN_LASER);
+// Liga/desliga tudo que depende do estado: camera, laser e LCD.
+// Roda na thread do laco (botao, ou postado pela camera quando ela falha).
+void definirSistemaAtivo(bool ativo) {
+    uint64_t versao = estado.atualizar([ativo](EstadoSistema& e) { e.ativo = ativo; });
+    if (ativo) {
+        iniciarCamera();
+        pisca->iniciar(padraoLaser);
+    } else {
+        pisca->parar();
+        pararCamera();
+        ringPreview.acordar();  // preview fecha a janela
+    }
+    atualizarLCD(versao);
+}
 
-    std::cout << "[MAIN] Inicializando LCD" << std::endl;
-    lcdInit();
-    lcdClear();
+int main(int argc, char** argv) {
+    if (!lerOpcoes(argc, argv)) {
+        std::cerr << "[MAIN] Opcoes invalidas" << std::endl;
+        return 1;
+    }
+    // Sem preview nem segmentacao so a ROI e convertida; o quadro inteiro fica no buffer do driver
+    bool comPreview = configPreview.modo != ModoPreview::Nenhum;
+    configCamera.copyFrame = comPreview || modoDeteccao == ModoDeteccao::Objetos;
+    estado.atualizar([](EstadoSistema& e) { e.modo = modoDeteccao; });
+
+    // Antes de qualquer thread: SIGINT/SIGTERM ficam bloqueados e chegam pelo laco
+    laco.observarSinais({SIGINT, SIGTERM}, []() {
+        LOG_INFO("[MAIN] Sinal recebido, finalizando...");
+        laco.parar();
+    });
+    iniciarLog();
+
+    if (!arquivoGravacao.empty() && !gravador.open(arquivoGravacao)) {
+        arquivoGravacao.clear();
+    }
 
-    lcdSetCursor(0, 0);
-    lcdPrint("Bem vindo!");
-    lcdSetCursor(1, 0);
-    lcdPrint("Pressione botao");
+    if (simular) {
+        gpioSimulado = new GpioSimulado();
+        usarGpio(std::unique_ptr<Gpio>(gpioSimulado));
+        gpioSimulado->conectarLcd(0, 1, 4, 5, 6, 7);  // mesmos pinos do lcdInit() padrao
+    } else {
+#ifdef COM_WIRINGPI
+        usarGpio(createWiringPiGpio());
+#else
+        LOG_AVISO("[MAIN] Compilado sem wiringPi: pinos simulados, sem hardware");
+        simular = true;
+#endif
+    }
+    LOG_INFO("[MAIN] Inicializando GPIO ({})", simular ? "simulado" : "wiringPi");
+    if (!gpio().iniciar()) {
+        LOG_ERRO("[MAIN] Falha ao inicializar o GPIO");
+        gravador.close();
+        pararLog();
+        return 1;
+    }
 
-    std::thread tBotao(threadBotao);
-    std::thread tCamera(threadCamera);
-    std::thread tLaser(threadLaser);
-    std::thread tLCD(threadLCD);
+    LOG_INFO("[MAIN] Configurando botao e laser");
+    configurarBotao(PIN_BOTAO);
+    configurarLaser(PIN_LASER);
+    pisca.reset(new PiscaLaser(laco, PIN_LASER));
+
+    if (lcdI2c) {
+        LOG_INFO("[MAIN] Inicializando LCD (I2C {} endereco {})", lcdI2cDispositivo, lcdI2cEndereco);
+        lcdInit(createI2cTransport(lcdI2cDispositivo, lcdI2cEndereco));
+    } else {
+        LOG_INFO("[MAIN] Inicializando LCD (GPIO)");
+        lcdInit();
+    }
 
-    std::cout << "[MAIN] Entrando no loop principal (ESC para sair)" << std::endl;
+    lcdCompose(0, "Bem vindo!");
+    lcdCompose(1, "Pressione botao");
+    lcdPresent();
+
+    // Aviso da thread de analise: drena o eventfd antes de pegar a versao,
+    // para um aviso que chegue depois da troca acordar o laco de novo
+    fdLCD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    laco.observar(fdLCD, []() {
+        uint64_t contador;
+        (void)!read(fdLCD, &contador, sizeof(contador));
+        uint64_t versao = versaoLCDPendente.exchange(0, std::memory_order_acq_rel);
+        if (versao) atualizarLCD(versao);
+    });
+
+    // O wiringPi encerra o processo se a interrupcao falhar; false so vem de
+    // erros do proprio modulo (eventfd) ou de outro backend
+    if (!iniciarEventosBotao(PIN_BOTAO)) {
+        LOG_ERRO("[BOTAO] Falha ao registrar interrupcao do botao");
+        pisca.reset();
+        gravador.close();
+        pararLog();
+        return 1;
+    }
+    // Interrupcao -> eventfd do botao -> laco; drena todos os eventos da fila
+    laco.observar(fdEventosBotao(), []() {
+        EventoBotao evento;
+        while (aguardarEventoBotao(evento, 0)) {
+            definirSistemaAtivo(!estado.ler().ativo);
+            LOG_INFO("[BOTAO] Botao pressionado, sistemaAtivo = {}", estado.ler().ativo);
+        }
+    });
+    if (gpioSimulado) {
+        gpioSimulado->roteiro(PIN_BOTAO, GpioSimulado::cliques(cliquesSimulados));
+    }
 
-    while (true) {
-        int key = cv::waitKey(1);
-        if (key == 27) {  // ESC
-            std::cout << "[MAIN] ESC pressionado, finalizando..." << std::endl;
-            exitProgram = true;
-            break;
+    if (!arquivoMetricas.empty()) {
+        if (escreverMetricas(arquivoMetricas)) {
+            int timerMetricas = laco.criarTimer([]() { escreverMetricas(arquivoMetricas); });
+            laco.armarTimer(timerMetricas, 1000000000LL, 1000000000LL);
+        } else {
+            LOG_AVISO("[MAIN] Nao foi possivel escrever metricas em {}", arquivoMetricas);
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
-    tBotao.join();
-    tCamera.join();
-    tLaser.join();
-    tLCD.join();
+    std::thread tPreview;
+    if (comPreview) {
+        tPreview = std::thread(threadPreview);
+    }
+
+    LOG_INFO("[MAIN] Entrando no laco de eventos (SIGINT/SIGTERM para sair)");
+    laco.executar();
+
+    exitProgram = true;
+    pisca.reset();  // desliga o laser
+    encerrarCamera();
+    close(fdLCD);  // a thread de analise ja terminou
+    if (!arquivoGravacao.empty()) {
+        gravador.close();
+        LOG_INFO("[MAIN] Gravacao {}: {} quadros, {} descartados", arquivoGravacao, gravador.recorded(),
+                 gravador.dropped());
+    }
+    pararEventosBotao();
+    ringPreview.acordar();
+    if (tPreview.joinable()) {
+        tPreview.join();
+    }
 
+    if (!arquivoMetricas.empty()) {
+        escreverMetricas(arquivoMetricas);
+    }
+    pararLog();
+    std::cout << "[MAIN] Metricas finais:\n" << resumoMetricas();
+    std::cout << "[MAIN] Mensagens de log descartadas: " << logsDescartados()
+              << ", suprimidas pelo limite: " << logsSuprimidos() << std::endl;
+    if (gpioSimulado) {
+        std::cout << "[MAIN] Simulacao:\n" << gpioSimulado->relatorio(PIN_BOTAO, PIN_LASER, padraoLaser);
+    }
     std::cout << "[MAIN] Programa finalizado com sucesso" << std::endl;
     return 0;
 }
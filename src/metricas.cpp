@@ -0,0 +1,140 @@
+// metricas.cpp
+#include "metricas.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+int64_t agoraNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+namespace {
+
+constexpr int NUM_ESTAGIOS = static_cast<int>(Estagio::Total);
+constexpr int NUM_CONTADORES = static_cast<int>(Contador::Total);
+constexpr int NUM_BALDES = 160;  // ate ~2^40 ns
+
+const char* NOMES_ESTAGIOS[NUM_ESTAGIOS] = {
+    "captura", "roi", "classificacao", "publicacao", "decisao", "lcd", "laser",
+    "laser_atraso", "preview"};
+const char* NOMES_CONTADORES[NUM_CONTADORES] = {
+    "quadros_capturados", "quadros_analisados", "quadros_descartados", "quadros_pulados",
+    "despertares_laco", "logs_descartados"};
+
+struct Histograma {
+    std::atomic<uint64_t> baldes[NUM_BALDES];
+    std::atomic<uint64_t> n;
+    std::atomic<uint64_t> somaNs;
+    std::atomic<uint64_t> maxNs;
+};
+
+Histograma histogramas[NUM_ESTAGIOS];
+std::atomic<uint64_t> contadores[NUM_CONTADORES];
+int64_t inicioNs = agoraNs();
+
+// 0-3 exatos; acima disso 4 baldes por potencia de 2 (erro < 25%)
+int balde(uint64_t ns) {
+    if (ns < 4) return static_cast<int>(ns);
+    int e = 63 - __builtin_clzll(ns);
+    int i = 4 * (e - 1) + static_cast<int>((ns >> (e - 2)) & 3);
+    return i < NUM_BALDES ? i : NUM_BALDES - 1;
+}
+
+uint64_t limiteSuperior(int i) {
+    if (i < 4) return i;
+    int e = i / 4 + 1;
+    uint64_t inferior = static_cast<uint64_t>(4 + i % 4) << (e - 2);
+    return inferior + (1ULL << (e - 2)) - 1;
+}
+
+// Limite superior do balde do percentil, sem passar do maximo observado
+double percentilUs(const uint64_t* copia, uint64_t total, uint64_t maxNs, double p) {
+    uint64_t alvo = static_cast<uint64_t>(p * total);
+    uint64_t acumulado = 0;
+    for (int i = 0; i < NUM_BALDES; i++) {
+        acumulado += copia[i];
+        if (acumulado > alvo) return std::min(limiteSuperior(i), maxNs) / 1000.0;
+    }
+    return maxNs / 1000.0;
+}
+
+}  // namespace
+
+void registrarLatencia(Estagio estagio, int64_t ns) {
+    if (ns < 0) ns = 0;
+    Histograma& h = histogramas[static_cast<int>(estagio)];
+    uint64_t valor = static_cast<uint64_t>(ns);
+
+    h.baldes[balde(valor)].fetch_add(1, std::memory_order_relaxed);
+    h.n.fetch_add(1, std::memory_order_relaxed);
+    h.somaNs.fetch_add(valor, std::memory_order_relaxed);
+
+    uint64_t atual = h.maxNs.load(std::memory_order_relaxed);
+    while (valor > atual && !h.maxNs.compare_exchange_weak(atual, valor, std::memory_order_relaxed)) {
+    }
+}
+
+void incrementar(Contador contador, uint64_t n) {
+    contadores[static_cast<int>(contador)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void definir(Contador contador, uint64_t valor) {
+    contadores[static_cast<int>(contador)].store(valor, std::memory_order_relaxed);
+}
+
+std::string resumoMetricas() {
+    static uint64_t analisadosAnterior = 0;
+    static int64_t instanteAnterior = inicioNs;
+
+    std::ostringstream out;
+    int64_t agora = agoraNs();
+    out << "uptime_s=" << (agora - inicioNs) / 1e9 << "\n";
+
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        out << NOMES_CONTADORES[c] << "=" << contadores[c].load(std::memory_order_relaxed) << "\n";
+    }
+
+    // Taxa de analise desde a ultima chamada
+    uint64_t analisados = contadores[static_cast<int>(Contador::QuadrosAnalisados)].load();
+    double segundos = (agora - instanteAnterior) / 1e9;
+    out << "fps_analise=" << (segundos > 0 ? (analisados - analisadosAnterior) / segundos : 0.0) << "\n";
+    analisadosAnterior = analisados;
+    instanteAnterior = agora;
+
+    for (int e = 0; e < NUM_ESTAGIOS; e++) {
+        const Histograma& h = histogramas[e];
+        uint64_t copia[NUM_BALDES];
+        uint64_t total = 0;
+        for (int i = 0; i < NUM_BALDES; i++) {
+            copia[i] = h.baldes[i].load(std::memory_order_relaxed);
+            total += copia[i];
+        }
+
+        uint64_t maxNs = h.maxNs.load(std::memory_order_relaxed);
+        out << "estagio=" << NOMES_ESTAGIOS[e] << " n=" << total;
+        if (total > 0) {
+            out << " media_us=" << h.somaNs.load(std::memory_order_relaxed) / 1000.0 / h.n.load()
+                << " p50_us=" << percentilUs(copia, total, maxNs, 0.50)
+                << " p90_us=" << percentilUs(copia, total, maxNs, 0.90)
+                << " p99_us=" << percentilUs(copia, total, maxNs, 0.99)
+                << " max_us=" << maxNs / 1000.0;
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+bool escreverMetricas(const std::string& arquivo) {
+    std::string temporario = arquivo + ".tmp";
+    {
+        std::ofstream out(temporario, std::ios::trunc);
+        if (!out) return false;
+        out << "# metricas do projeto\n" << resumoMetricas();
+    }
+    return std::rename(temporario.c_str(), arquivo.c_str()) == 0;
+}
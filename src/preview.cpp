@@ -0,0 +1,132 @@
+// preview.cpp
+#include "preview.h"
+#include "log.h"
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace {
+
+const char CABECALHO_HTTP[] =
+    "HTTP/1.0 200 OK\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: close\r\n"
+    "Content-Type: multipart/x-mixed-replace; boundary=quadro\r\n\r\n";
+
+bool enviarTudo(int fd, const void* dados, size_t tamanho) {
+    const char* p = static_cast<const char*>(dados);
+    while (tamanho > 0) {
+        ssize_t n = send(fd, p, tamanho, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        tamanho -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+cv::Rect escalar(const cv::Rect& r, double fx, double fy) {
+    return cv::Rect(static_cast<int>(r.x * fx), static_cast<int>(r.y * fy),
+                    static_cast<int>(r.width * fx), static_cast<int>(r.height * fy));
+}
+
+}  // namespace
+
+void anotarQuadro(const Frame& frame, cv::Size tamanho, cv::Mat& saida) {
+    // Reduz antes de desenhar: o desenho fica proporcional ao quadro pequeno
+    cv::resize(frame.imagem, saida, tamanho);
+    double fx = static_cast<double>(tamanho.width) / frame.imagem.cols;
+    double fy = static_cast<double>(tamanho.height) / frame.imagem.rows;
+
+    // Retangulo na regiao central e texto com a cor detectada
+    cv::rectangle(saida, escalar(frame.roi, fx, fy), cv::Scalar(255, 0, 0), 2);
+    cv::putText(saida, nomeCor(frame.cor), cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0,
+                cv::Scalar(255, 255, 255), 2);
+
+    // No modo Objetos: caixa e centroide de cada regiao encontrada
+    for (const Objeto& o : frame.objetos) {
+        cv::Rect caixa = escalar(o.caixa, fx, fy);
+        cv::rectangle(saida, caixa, cv::Scalar(0, 255, 255), 1);
+        cv::circle(saida, cv::Point(static_cast<int>(o.cx * fx), static_cast<int>(o.cy * fy)), 2,
+                   cv::Scalar(0, 255, 255), -1);
+        cv::putText(saida, nomeCor(o.cor), caixa.tl(), cv::FONT_HERSHEY_SIMPLEX, 0.4,
+                    cv::Scalar(0, 255, 255), 1);
+    }
+}
+
+ServidorMjpeg::~ServidorMjpeg() {
+    fechar();
+}
+
+bool ServidorMjpeg::abrir(int porta) {
+    fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd_ < 0) return false;
+
+    int um = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+
+    sockaddr_in endereco{};
+    endereco.sin_family = AF_INET;
+    endereco.sin_port = htons(static_cast<uint16_t>(porta));
+    endereco.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 || listen(fd_, 4) < 0) {
+        LOG_ERRO("[PREVIEW] Nao foi possivel escutar em 127.0.0.1:{}: {}", porta, std::strerror(errno));
+        fechar();
+        return false;
+    }
+    LOG_INFO("[PREVIEW] MJPEG em http://127.0.0.1:{}/", porta);
+    return true;
+}
+
+void ServidorMjpeg::fechar() {
+    for (int c : clientes_) close(c);
+    clientes_.clear();
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+}
+
+void ServidorMjpeg::aceitar() {
+    while (true) {
+        int cliente = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (cliente < 0) return;
+
+        // Envio bloqueante com prazo: um cliente travado nao segura o preview
+        timeval prazo{0, 200000};
+        setsockopt(cliente, SOL_SOCKET, SO_SNDTIMEO, &prazo, sizeof(prazo));
+
+        // A requisicao em si nao importa: descarta o que ja chegou e responde
+        char descarte[1024];
+        (void)!recv(cliente, descarte, sizeof(descarte), MSG_DONTWAIT);
+        if (!enviarTudo(cliente, CABECALHO_HTTP, sizeof(CABECALHO_HTTP) - 1)) {
+            close(cliente);
+            continue;
+        }
+        clientes_.push_back(cliente);
+        LOG_INFO("[PREVIEW] Cliente conectado ({} no total)", clientes_.size());
+    }
+}
+
+void ServidorMjpeg::enviar(const cv::Mat& quadro, int qualidade) {
+    if (clientes_.empty()) return;
+
+    cv::imencode(".jpg", quadro, jpeg_, {cv::IMWRITE_JPEG_QUALITY, qualidade});
+    std::string parte = "--quadro\r\nContent-Type: image/jpeg\r\nContent-Length: " +
+                        std::to_string(jpeg_.size()) + "\r\n\r\n";
+
+    for (size_t i = 0; i < clientes_.size();) {
+        int c = clientes_[i];
+        bool ok = enviarTudo(c, parte.data(), parte.size()) && enviarTudo(c, jpeg_.data(), jpeg_.size()) &&
+                  enviarTudo(c, "\r\n", 2);
+        if (ok) {
+            i++;
+            continue;
+        }
+        close(c);
+        clientes_.erase(clientes_.begin() + i);
+        LOG_INFO("[PREVIEW] Cliente desconectado ({} restantes)", clientes_.size());
+    }
+}
@@ -0,0 +1,168 @@
+// segmentacao.cpp
+#include "segmentacao.h"
+#include <algorithm>
+
+SegmentadorCor::SegmentadorCor(const ClassificadorCor& classificador, ConfigSegmentacao config)
+    : classificador_(classificador), config_(config) {}
+
+int SegmentadorCor::raiz(int rotulo) {
+    while (pai_[rotulo] != rotulo) {
+        pai_[rotulo] = pai_[pai_[rotulo]];
+        rotulo = pai_[rotulo];
+    }
+    return rotulo;
+}
+
+void SegmentadorCor::unir(int a, int b) {
+    a = raiz(a);
+    b = raiz(b);
+    if (a < b) pai_[b] = a;
+    else if (b < a) pai_[a] = b;
+}
+
+// Primeira passada da rotulacao numa faixa de linhas. Os rotulos novos sao o
+// indice do pixel + 1, entao cada faixa so escreve na sua parte de pai_
+void SegmentadorCor::rotularFaixa(const cv::Mat& bgr, int y0, int y1) {
+    int cols = bgr.cols;
+    for (int y = y0; y < y1; y++) {
+        uint8_t* classe = classes_.ptr<uint8_t>(y);
+        classificador_.classificarLinha(bgr.ptr<uint8_t>(y), cols, classe);
+
+        const uint8_t* acima = y > y0 ? classes_.ptr<uint8_t>(y - 1) : nullptr;
+        int* rotulo = &rotulos_[static_cast<size_t>(y) * cols];
+
+        for (int x = 0; x < cols; x++) {
+            uint8_t c = classe[x];
+            if (c == static_cast<uint8_t>(Cor::Indefinido)) {
+                rotulo[x] = 0;
+                continue;
+            }
+
+            int esquerda = x > 0 && classe[x - 1] == c ? rotulo[x - 1] : 0;
+            int cima = acima && acima[x] == c ? rotulo[x - cols] : 0;
+
+            if (esquerda && cima) {
+                unir(esquerda, cima);
+                rotulo[x] = std::min(esquerda, cima);
+            } else if (esquerda || cima) {
+                rotulo[x] = esquerda ? esquerda : cima;
+            } else {
+                int novo = y * cols + x + 1;
+                pai_[novo] = novo;
+                rotulo[x] = novo;
+            }
+        }
+    }
+}
+
+const std::vector<Objeto>& SegmentadorCor::segmentar(const cv::Mat& bgr) {
+    objetos_.clear();
+    if (bgr.empty()) return objetos_;
+
+    int rows = bgr.rows;
+    int cols = bgr.cols;
+    size_t total = static_cast<size_t>(rows) * cols;
+
+    classes_.create(rows, cols, CV_8UC1);
+    rotulos_.resize(total);
+    pai_.resize(total + 1);
+    objetoDaRaiz_.assign(total + 1, -1);
+
+    int faixas = config_.faixas > 0 ? config_.faixas : std::max(1, cv::getNumThreads());
+    faixas = std::min(faixas, rows);
+
+    cv::parallel_for_(cv::Range(0, faixas), [&](const cv::Range& intervalo) {
+        for (int f = intervalo.start; f < intervalo.end; f++) {
+            rotularFaixa(bgr, f * rows / faixas, (f + 1) * rows / faixas);
+        }
+    });
+
+    // Costura: une regioes da mesma cor que atravessam a borda entre faixas
+    for (int f = 1; f < faixas; f++) {
+        int y = f * rows / faixas;
+        const uint8_t* classe = classes_.ptr<uint8_t>(y);
+        const uint8_t* acima = classes_.ptr<uint8_t>(y - 1);
+        const int* rotulo = &rotulos_[static_cast<size_t>(y) * cols];
+        for (int x = 0; x < cols; x++) {
+            if (rotulo[x] && classe[x] == acima[x]) unir(rotulo[x], rotulo[x - cols]);
+        }
+    }
+
+    // Segunda passada: acumula area, centroide e caixa por raiz
+    std::vector<long long> somaX, somaY;
+    for (int y = 0; y < rows; y++) {
+        const int* rotulo = &rotulos_[static_cast<size_t>(y) * cols];
+        const uint8_t* classe = classes_.ptr<uint8_t>(y);
+        for (int x = 0; x < cols; x++) {
+            if (!rotulo[x]) continue;
+            int r = raiz(rotulo[x]);
+
+            int i = objetoDaRaiz_[r];
+            if (i < 0) {
+                i = objetoDaRaiz_[r] = static_cast<int>(objetos_.size());
+                Objeto novo;
+                novo.cor = static_cast<Cor>(classe[x]);
+                novo.caixa = cv::Rect(x, y, 1, 1);
+                objetos_.push_back(novo);
+                somaX.push_back(0);
+                somaY.push_back(0);
+            }
+
+            Objeto& o = objetos_[i];
+            o.area++;
+            somaX[i] += x;
+            somaY[i] += y;
+            cv::Rect& c = o.caixa;
+            if (x < c.x) { c.width += c.x - x; c.x = x; }
+            if (x >= c.x + c.width) c.width = x - c.x + 1;
+            c.height = y - c.y + 1;  // linhas sempre crescem
+        }
+    }
+
+    for (size_t i = 0; i < objetos_.size(); i++) {
+        objetos_[i].cx = static_cast<double>(somaX[i]) / objetos_[i].area;
+        objetos_[i].cy = static_cast<double>(somaY[i]) / objetos_[i].area;
+    }
+
+    int areaMinima = config_.areaMinima;
+    objetos_.erase(std::remove_if(objetos_.begin(), objetos_.end(),
+                                  [areaMinima](const Objeto& o) { return o.area < areaMinima; }),
+                   objetos_.end());
+    std::sort(objetos_.begin(), objetos_.end(),
+              [](const Objeto& a, const Objeto& b) { return a.area > b.area; });
+    return objetos_;
+}
+
+const Objeto* escolherObjeto(const std::vector<Objeto>& objetos, cv::Size tamanho, CriterioObjeto criterio) {
+    if (objetos.empty()) return nullptr;
+    if (criterio == CriterioObjeto::Maior) return &objetos.front();
+
+    // Mais proximo do centro do quadro, onde o laser aponta
+    double centroX = tamanho.width / 2.0;
+    double centroY = tamanho.height / 2.0;
+    const Objeto* melhor = nullptr;
+    double melhorDist = 0;
+    for (const Objeto& o : objetos) {
+        double dist = (o.cx - centroX) * (o.cx - centroX) + (o.cy - centroY) * (o.cy - centroY);
+        if (!melhor || dist < melhorDist) {
+            melhor = &o;
+            melhorDist = dist;
+        }
+    }
+    return melhor;
+}
+
+float purezaObjeto(const cv::Mat& classes, const Objeto& objeto) {
+    cv::Rect caixa = objeto.caixa & cv::Rect(0, 0, classes.cols, classes.rows);
+    uint8_t cor = static_cast<uint8_t>(objeto.cor);
+    int classificados = 0, daCor = 0;
+    for (int y = caixa.y; y < caixa.y + caixa.height; y++) {
+        const uint8_t* linha = classes.ptr<uint8_t>(y);
+        for (int x = caixa.x; x < caixa.x + caixa.width; x++) {
+            if (linha[x] == static_cast<uint8_t>(Cor::Indefinido)) continue;
+            classificados++;
+            daCor += linha[x] == cor;
+        }
+    }
+    return classificados ? static_cast<float>(daCor) / classificados : 0.0f;
+}
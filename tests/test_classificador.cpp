@@ -0,0 +1,159 @@
+// test_classificador.cpp
+// Confere as tabelas do ClassificadorCor contra as regras de referencia e o
+// kernel vetorial (NEON no Pi, SSE2 no x86) contra o caminho escalar.
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "camera.h"
+#include "classificador.h"
+
+namespace {
+
+int falhas = 0;
+
+void verificar(const char* nome, bool ok, const std::string& detalhe = "") {
+    std::cout << "[TESTE] " << nome << ": " << (ok ? "ok" : "FALHOU");
+    if (!detalhe.empty()) std::cout << " (" << detalhe << ")";
+    std::cout << std::endl;
+    if (!ok) falhas++;
+}
+
+// As faixas RGB seguem os limiares das regras: a tabela tem que reproduzir
+// detectColorRGB em todas as 2^24 cores
+void tabelaRGBExata() {
+    ClassificadorCor classificador(RegrasCor::RGB);
+    long divergentes = 0;
+    for (int b = 0; b < 256; b++) {
+        for (int g = 0; g < 256; g++) {
+            for (int r = 0; r < 256; r++) {
+                std::string esperado = detectColorRGB(cv::Vec3b(b, g, r));
+                if (esperado != nomeCor(classificador.classificar(b, g, r))) divergentes++;
+            }
+        }
+    }
+    verificar("tabela RGB == detectColorRGB", divergentes == 0,
+              std::to_string(divergentes) + " cores divergentes");
+}
+
+// Nas regras HSV as faixas sao uniformes, 8 valores por canal, e cada celula
+// guarda a cor do seu centro. A tabela so pode errar em celulas cortadas por
+// uma fronteira das regras; onde as 512 cores da celula concordam entre si
+// ela tem que acertar todas. Entao o erro fica limitado as celulas de
+// fronteira (28% das cores); dentro delas, escolher a cor do centro erra
+// 4.92% do total hoje. Tudo aqui e deterministico (bgrParaHSV e nosso), e o
+// teto de 5% pega qualquer piora da quantizacao.
+constexpr double ERRO_MAXIMO_HSV = 0.05;
+
+void tabelaHSVNaFronteira() {
+    ClassificadorCor classificador(RegrasCor::HSV);
+    long divergentesUniformes = 0;
+    long divergentes = 0;
+    long emFronteira = 0;
+    Cor referencia[512];
+
+    for (int cb = 0; cb < 32; cb++) {
+        for (int cg = 0; cg < 32; cg++) {
+            for (int cr = 0; cr < 32; cr++) {
+                bool uniforme = true;
+                int i = 0;
+                for (int b = cb * 8; b < cb * 8 + 8; b++) {
+                    for (int g = cg * 8; g < cg * 8 + 8; g++) {
+                        for (int r = cr * 8; r < cr * 8 + 8; r++, i++) {
+                            int h, s, v;
+                            bgrParaHSV(b, g, r, h, s, v);
+                            referencia[i] = corReferenciaHSV(h, s, v);
+                            uniforme = uniforme && referencia[i] == referencia[0];
+                        }
+                    }
+                }
+
+                long erradas = 0;
+                i = 0;
+                for (int b = cb * 8; b < cb * 8 + 8; b++) {
+                    for (int g = cg * 8; g < cg * 8 + 8; g++) {
+                        for (int r = cr * 8; r < cr * 8 + 8; r++, i++) {
+                            erradas += classificador.classificar(b, g, r) != referencia[i];
+                        }
+                    }
+                }
+                divergentes += erradas;
+                if (uniforme) divergentesUniformes += erradas;
+                else emFronteira += 512;
+            }
+        }
+    }
+
+    const double total = 1 << 24;
+    verificar("tabela HSV exata fora das fronteiras", divergentesUniformes == 0,
+              std::to_string(divergentesUniformes) + " cores divergentes em celulas uniformes");
+    verificar("tabela HSV: erro <= 5% e so em celulas de fronteira",
+              divergentes <= emFronteira && divergentes / total <= ERRO_MAXIMO_HSV, "erro " + std::to_string(divergentes / total * 100) + "%, fronteira " +
+                  std::to_string(emFronteira / total * 100) + "%");
+}
+
+// classificarLinha() e votar() passam blocos de 16 pixels pelo kernel
+// vetorial e o resto pelo escalar: todas as cores, com larguras que exercitam
+// os dois caminhos, e uma ROI nao continua
+void kernelIgualEscalar(RegrasCor regras, const char* nome) {
+    ClassificadorCor classificador(regras);
+    long divergentes = 0;
+
+    // 2^24 cores em linhas de 256 pixels (r varia na linha)
+    std::vector<uint8_t> linha(256 * 3);
+    uint8_t classes[256];
+    for (int b = 0; b < 256; b++) {
+        for (int g = 0; g < 256; g++) {
+            for (int r = 0; r < 256; r++) {
+                linha[r * 3] = static_cast<uint8_t>(b);
+                linha[r * 3 + 1] = static_cast<uint8_t>(g);
+                linha[r * 3 + 2] = static_cast<uint8_t>(r);
+            }
+            classificador.classificarLinha(linha.data(), 256, classes);
+            for (int r = 0; r < 256; r++) {
+                divergentes += classes[r] != static_cast<uint8_t>(classificador.classificar(b, g, r));
+            }
+        }
+    }
+
+    // Imagem pseudoaleatoria; votar() em recortes de varias larguras
+    cv::Mat imagem(64, 67, CV_8UC3);
+    uint32_t semente = 12345;
+    for (int y = 0; y < imagem.rows; y++) {
+        uint8_t* p = imagem.ptr<uint8_t>(y);
+        for (int x = 0; x < imagem.cols * 3; x++) {
+            semente = semente * 1664525u + 1013904223u;
+            p[x] = static_cast<uint8_t>(semente >> 24);
+        }
+    }
+    long histogramasDivergentes = 0;
+    for (int largura = 1; largura <= 50; largura++) {
+        cv::Mat recorte = imagem(cv::Rect(largura % 7, 3, largura, 40));
+        ResultadoCor vetorial = classificador.votar(recorte);
+        int escalar[NUM_CORES] = {};
+        for (int y = 0; y < recorte.rows; y++) {
+            const uint8_t* p = recorte.ptr<uint8_t>(y);
+            for (int x = 0; x < recorte.cols; x++) {
+                escalar[static_cast<int>(classificador.classificar(p[x * 3], p[x * 3 + 1], p[x * 3 + 2]))]++;
+            }
+        }
+        histogramasDivergentes += !std::equal(escalar, escalar + NUM_CORES, vetorial.votos);
+    }
+
+    verificar(nome, divergentes == 0 && histogramasDivergentes == 0,
+              std::to_string(divergentes) + " pixels, " + std::to_string(histogramasDivergentes) +
+                  " histogramas divergentes");
+}
+
+}  // namespace
+
+int main() {
+    tabelaRGBExata();
+    tabelaHSVNaFronteira();
+    kernelIgualEscalar(RegrasCor::RGB, "kernel RGB == escalar");
+    kernelIgualEscalar(RegrasCor::HSV, "kernel HSV == escalar");
+    return falhas ? 1 : 0;
+}
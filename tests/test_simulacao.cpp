@@ -0,0 +1,127 @@
+// test_simulacao.cpp
+// Botao, LCD e laser no laco de eventos sobre o GPIO simulado, por um tempo
+// fixo e com cliques roteirizados. Confere o relatorio da simulacao: texto
+// final do LCD, nenhuma violacao de tempo do HD44780 e o erro do pisca.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "botao.h"
+#include "hal.h"
+#include "hal_simulado.h"
+#include "laco_eventos.h"
+#include "laser.h"
+#include "lcd.h"
+
+namespace {
+
+constexpr int PIN_BOTAO = 26;
+constexpr int PIN_LASER = 19;
+constexpr int64_t DURACAO_NS = 1300000000;
+
+// Tres cliques: liga, desliga e liga de novo; o teste termina ligado. As
+// fases do pisca contam a partir do clique que liga, entao o clique que
+// desliga fica no meio de uma fase (425 ms = 8,5 periodos) e nao disputa
+// uma troca do timerfd.
+const std::vector<int> CLIQUES_MS = {100, 525, 925};
+const std::vector<int> PADRAO_LASER_MS = {50, 50};
+
+// O pisca roda em timerfd com prazos absolutos; o atraso normal fica em
+// dezenas de us. O teste olha a mediana contra 10% da fase: despertares
+// atrasados numa maquina de CI carregada nao derrubam o teste, mas um prazo
+// relativo que acumula ou uma espera de barramento no laco desloca a maioria
+// dos intervalos.
+constexpr double ERRO_MEDIANO_LASER_US = 5000;
+
+int falhas = 0;
+
+void verificar(const std::string& nome, bool ok, const std::string& detalhe) {
+    std::cout << "[TESTE] " << nome << ": " << (ok ? "ok" : "FALHOU") << " (" << detalhe << ")" << std::endl;
+    if (!ok) falhas++;
+}
+
+// Valor de uma linha chave=valor do relatorio, sem aspas
+std::string valor(const std::string& relatorio, const std::string& chave) {
+    std::istringstream linhas(relatorio);
+    std::string linha;
+    while (std::getline(linhas, linha)) {
+        if (linha.compare(0, chave.size() + 1, chave + "=") != 0) continue;
+        std::string v = linha.substr(chave.size() + 1);
+        if (v.size() >= 2 && v.front() == '"' && v.back() == '"') v = v.substr(1, v.size() - 2);
+        return v;
+    }
+    return "";
+}
+
+double numero(const std::string& relatorio, const std::string& chave) {
+    std::string v = valor(relatorio, chave);
+    return v.empty() ? -1.0 : std::stod(v);
+}
+
+}  // namespace
+
+int main() {
+    GpioSimulado* sim = new GpioSimulado();
+    usarGpio(std::unique_ptr<Gpio>(sim));
+    sim->conectarLcd(0, 1, 4, 5, 6, 7);
+
+    LacoEventos laco;
+    configurarBotao(PIN_BOTAO);
+    configurarLaser(PIN_LASER);
+    PiscaLaser pisca(laco, PIN_LASER);
+    lcdInit();
+
+    bool ativo = false;
+    auto desenhar = [&]() {
+        lcdCompose(0, ativo ? "Sistema ativo" : "Sistema inativo");
+        lcdCompose(1, ativo ? "Laser piscando" : "Pressione botao");
+        lcdPresent();
+    };
+    desenhar();
+
+    if (!iniciarEventosBotao(PIN_BOTAO)) {
+        std::cout << "[TESTE] interrupcao do botao nao registrou" << std::endl;
+        return 1;
+    }
+    laco.observar(fdEventosBotao(), [&]() {
+        EventoBotao evento;
+        while (aguardarEventoBotao(evento, 0)) {
+            ativo = !ativo;
+            if (ativo) pisca.iniciar(PADRAO_LASER_MS);
+            else pisca.parar();
+            desenhar();
+        }
+    });
+
+    int fim = laco.criarTimer([&]() { laco.parar(); });
+    laco.armarTimer(fim, DURACAO_NS);
+    sim->roteiro(PIN_BOTAO, GpioSimulado::cliques(CLIQUES_MS));
+    laco.executar();
+    pararEventosBotao();
+
+    std::string relatorio = sim->relatorio(PIN_BOTAO, PIN_LASER, PADRAO_LASER_MS);
+    std::cout << relatorio;
+
+    verificar("texto do LCD",
+              valor(relatorio, "sim_lcd_linha0") == "Sistema ativo   " &&
+                  valor(relatorio, "sim_lcd_linha1") == "Laser piscando  ",
+              valor(relatorio, "sim_lcd_linha0") + "|" + valor(relatorio, "sim_lcd_linha1"));
+    verificar("sem violacoes do HD44780", numero(relatorio, "sim_lcd_violacoes") == 0,
+              valor(relatorio, "sim_lcd_violacoes") + " violacoes");
+    verificar("cada clique redesenhou o LCD",
+              numero(relatorio, "sim_botao_cliques") == CLIQUES_MS.size() &&
+                  numero(relatorio, "sim_botao_lcd_respostas") == CLIQUES_MS.size(),
+              valor(relatorio, "sim_botao_cliques") + " cliques, " + valor(relatorio, "sim_botao_lcd_respostas") +
+                  " respostas");
+    // Ligado de 100 a 525 ms e de 925 a 1300 ms com periodo de 50 ms: ~14
+    // intervalos inteiros, sem os cortados por clique ou pelo fim
+    double intervalos = numero(relatorio, "sim_laser_intervalos");
+    double erroMediano = numero(relatorio, "sim_laser_erro_p50_us");
+    verificar("pisca do laser no padrao",
+              intervalos >= 10 && erroMediano >= 0 && erroMediano <= ERRO_MEDIANO_LASER_US,
+              valor(relatorio, "sim_laser_intervalos") + " intervalos, erro mediano " +
+                  valor(relatorio, "sim_laser_erro_p50_us") + " us, max " +
+                  valor(relatorio, "sim_laser_erro_max_us") + " us");
+    return falhas ? 1 : 0;
+}